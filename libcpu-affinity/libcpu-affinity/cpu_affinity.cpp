@@ -0,0 +1,57 @@
+#include <libcpu-affinity/cpu_affinity.hpp>
+
+#include <algorithm>
+#include <numeric>
+#include <thread>
+
+#if defined(__linux__)
+#   include <pthread.h>
+#   include <sched.h>
+#endif
+
+auto available_cpu_count() -> u32
+{
+   return static_cast<u32>(allowed_cpus().size());
+}
+
+auto allowed_cpus() -> std::vector<int>
+{
+   std::vector<int> cpus;
+
+#if defined(__linux__)
+   cpu_set_t set;
+   CPU_ZERO(&set);
+   if (sched_getaffinity(0, sizeof(set), &set) == 0)
+   {
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+      {
+         if (CPU_ISSET(cpu, &set))
+         {
+            cpus.push_back(cpu);
+         }
+      }
+   }
+#endif
+
+   if (cpus.empty())
+   {
+      cpus.resize(std::max(std::thread::hardware_concurrency(), 1U));
+      std::iota(begin(cpus), end(cpus), 0);
+   }
+
+   return cpus;
+}
+
+void pin_current_thread(int cpu)
+{
+#if defined(__linux__)
+   cpu_set_t set;
+   CPU_ZERO(&set);
+   CPU_SET(cpu, &set);
+
+   // Pinning is an optimization, a refusal leaves the thread where the scheduler put it.
+   pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+   static_cast<void>(cpu);
+#endif
+}
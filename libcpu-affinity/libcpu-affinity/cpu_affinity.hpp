@@ -0,0 +1,24 @@
+#ifndef LIBCPU_AFFINITY_CPU_AFFINITY_HPP_
+#define LIBCPU_AFFINITY_CPU_AFFINITY_HPP_
+
+#include <libcpu-affinity/types.hpp>
+
+#include <vector>
+
+/**
+ * Number of CPUs this process may run on, which under MPI is one per core handed to the rank by
+ * the launcher.
+ */
+auto available_cpu_count() -> u32;
+
+/**
+ * The CPUs this process may run on, in increasing order.
+ */
+auto allowed_cpus() -> std::vector<int>;
+
+/**
+ * Restricts the calling thread to `cpu`, leaving it where it is if the system refuses.
+ */
+void pin_current_thread(int cpu);
+
+#endif // LIBCPU_AFFINITY_CPU_AFFINITY_HPP_
@@ -0,0 +1,8 @@
+#ifndef LIBCPU_AFFINITY_TYPES_HPP_
+#define LIBCPU_AFFINITY_TYPES_HPP_
+
+#include <cstdint>
+
+using u32 = std::uint32_t;
+
+#endif // LIBCPU_AFFINITY_TYPES_HPP_
@@ -0,0 +1,46 @@
+#include <libcpu-affinity/cpu_affinity.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+#if defined(__linux__)
+#   include <sched.h>
+#endif
+
+// The allowed CPUs are distinct, in order and as many as available_cpu_count(), and a thread
+// pinned to one of them runs there.
+auto main() -> int
+{
+   const auto cpus = allowed_cpus();
+
+   bool passed = true;
+   if (cpus.empty() or cpus.size() != available_cpu_count() or
+       std::adjacent_find(cpus.begin(), cpus.end(), std::greater_equal<>{}) != cpus.end())
+   {
+      std::cerr << "the " << cpus.size() << " allowed CPUs are not " << available_cpu_count()
+                << " distinct ones in increasing order\n";
+      passed = false;
+   }
+
+#if defined(__linux__)
+   for (const int cpu : {cpus.front(), cpus.back()})
+   {
+      int running_on = -1;
+      std::thread([&] {
+         pin_current_thread(cpu);
+         running_on = sched_getcpu();
+      }).join();
+
+      if (running_on != cpu)
+      {
+         std::cerr << "a thread pinned to CPU " << cpu << " runs on CPU " << running_on << '\n';
+         passed = false;
+      }
+   }
+#endif
+
+   return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
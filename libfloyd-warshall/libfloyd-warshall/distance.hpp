@@ -0,0 +1,39 @@
+#ifndef LIBFLOYD_WARSHALL_DISTANCE_HPP_
+#define LIBFLOYD_WARSHALL_DISTANCE_HPP_
+
+#include <libfloyd-warshall/types.hpp>
+
+#include <limits>
+
+/**
+ * Distance between two vertices without a path between them. Half the largest i32, so that the
+ * sum of two distances never overflows and the kernels need no test for it.
+ */
+inline constexpr i32 tombstone = std::numeric_limits<i32>::max() / 2;
+
+/**
+ * Largest edge weight, in absolute value, of a graph of `vertex_count` vertices that the kernels
+ * solve exactly. A shortest path has at most vertex_count - 1 edges, so with weights within it
+ * every distance stays under tombstone / 2 in absolute value. Adding a path to a tombstone, as
+ * the kernels do without testing, then leaves an unreachable distance at or above tombstone / 2,
+ * and reachable() tells the two apart. Weights up to 100 allow about 5.3 million vertices.
+ */
+constexpr auto max_edge_weight(u32 vertex_count) noexcept -> i32
+{
+   constexpr i32 max_distance = tombstone / 2 - 1;
+
+   return vertex_count <= 1 ? max_distance : static_cast<i32>(max_distance / (vertex_count - 1));
+}
+
+/**
+ * Whether `distance` is that of an actual path. Without tests, a negative edge after an
+ * unreachable vertex brings the distance under the tombstone, by at most the length of a path,
+ * so anything in its upper half still counts as unreachable as long as the edge weights are
+ * within max_edge_weight().
+ */
+constexpr auto reachable(i32 distance) noexcept -> bool
+{
+   return distance < tombstone / 2;
+}
+
+#endif // LIBFLOYD_WARSHALL_DISTANCE_HPP_
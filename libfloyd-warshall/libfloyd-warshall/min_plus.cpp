@@ -0,0 +1,110 @@
+#include <libfloyd-warshall/min_plus.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <immintrin.h>
+#   define LIBFLOYD_WARSHALL_X86 1
+#endif
+
+namespace
+{
+   // `out` and `row` are either the same row or disjoint, so no iteration depends on another and
+   // the compiler is free to vectorize for the baseline of the target.
+   void update_scalar(i32* out, const i32* row, i32 through, u32 count) noexcept
+   {
+#pragma GCC ivdep
+      for (u32 j = 0; j < count; ++j)
+      {
+         out[j] = std::min(out[j], through + row[j]);
+      }
+   }
+
+#if defined(LIBFLOYD_WARSHALL_X86)
+   __attribute__((target("avx2"))) void update_avx2(i32* out, const i32* row, i32 through,
+                                                     u32 count) noexcept
+   {
+      const __m256i through_lanes = _mm256_set1_epi32(through);
+
+      u32 j = 0;
+      for (; j + 8 <= count; j += 8)
+      {
+         const __m256i candidate = _mm256_add_epi32(
+            through_lanes, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + j)));
+         const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(out + j));
+         _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j),
+                             _mm256_min_epi32(current, candidate));
+      }
+
+      update_scalar(out + j, row + j, through, count - j);
+   }
+
+   __attribute__((target("avx512f"))) void update_avx512(i32* out, const i32* row, i32 through,
+                                                          u32 count) noexcept
+   {
+      const __m512i through_lanes = _mm512_set1_epi32(through);
+
+      u32 j = 0;
+      for (; j + 16 <= count; j += 16)
+      {
+         const __m512i candidate = _mm512_add_epi32(through_lanes, _mm512_loadu_si512(row + j));
+         const __m512i current = _mm512_loadu_si512(out + j);
+         _mm512_storeu_si512(out + j, _mm512_min_epi32(current, candidate));
+      }
+
+      // The tail in one masked step rather than up to 15 scalar ones.
+      const auto tail = static_cast<__mmask16>((1U << (count - j)) - 1);
+      const __m512i candidate =
+         _mm512_add_epi32(through_lanes, _mm512_maskz_loadu_epi32(tail, row + j));
+      const __m512i current = _mm512_maskz_loadu_epi32(tail, out + j);
+      _mm512_mask_storeu_epi32(out + j, tail, _mm512_min_epi32(current, candidate));
+   }
+#endif
+
+   auto find_supported_kernels() -> std::vector<min_plus_kernel>
+   {
+      std::vector<min_plus_kernel> kernels;
+
+#if defined(LIBFLOYD_WARSHALL_X86)
+      __builtin_cpu_init();
+
+      if (__builtin_cpu_supports("avx512f"))
+      {
+         kernels.push_back({update_avx512, "avx512"});
+      }
+      if (__builtin_cpu_supports("avx2"))
+      {
+         kernels.push_back({update_avx2, "avx2"});
+      }
+#endif
+
+      kernels.push_back({update_scalar, "scalar"});
+
+      return kernels;
+   }
+} // namespace
+
+void min_plus_row(i32* out, const i32* row, i32 through, u32 count) noexcept
+{
+   static const auto update = supported_min_plus_kernels().front().update;
+
+   update(out, row, through, count);
+}
+
+void min_plus_row_scalar(i32* out, const i32* row, i32 through, u32 count) noexcept
+{
+   update_scalar(out, row, through, count);
+}
+
+auto supported_min_plus_kernels() -> std::span<const min_plus_kernel>
+{
+   static const std::vector<min_plus_kernel> kernels = find_supported_kernels();
+
+   return kernels;
+}
+
+auto min_plus_kernel_name() -> std::string_view
+{
+   return supported_min_plus_kernels().front().name;
+}
@@ -0,0 +1,45 @@
+#ifndef LIBFLOYD_WARSHALL_MIN_PLUS_HPP_
+#define LIBFLOYD_WARSHALL_MIN_PLUS_HPP_
+
+#include <libfloyd-warshall/distance.hpp>
+#include <libfloyd-warshall/types.hpp>
+
+#include <span>
+#include <string_view>
+
+/**
+ * out[j] = min(out[j], through + row[j]) for every j below `count`, the update of a row i through
+ * a vertex k, `through` being the distance from i to k and `row` the distances from k.
+ *
+ * Without any test for unreachable vertices: their distance, the tombstone, is small enough that
+ * the sum of two of them cannot overflow, so every lane takes the same path. Dispatched at
+ * runtime to the widest of AVX-512 or AVX2 supported by the host, with a scalar fallback. `out`
+ * may be `row` itself, each lane being read before it is written.
+ */
+void min_plus_row(i32* out, const i32* row, i32 through, u32 count) noexcept;
+
+/**
+ * Reference implementation of min_plus_row, used for verification.
+ */
+void min_plus_row_scalar(i32* out, const i32* row, i32 through, u32 count) noexcept;
+
+/**
+ * One implementation of min_plus_row, for one instruction set.
+ */
+struct min_plus_kernel
+{
+   void (*update)(i32* out, const i32* row, i32 through, u32 count) noexcept;
+   std::string_view name;
+};
+
+/**
+ * Every kernel compiled in that the host supports, widest first; min_plus_row runs the first one.
+ */
+auto supported_min_plus_kernels() -> std::span<const min_plus_kernel>;
+
+/**
+ * Name of the instruction set selected by min_plus_row.
+ */
+auto min_plus_kernel_name() -> std::string_view;
+
+#endif // LIBFLOYD_WARSHALL_MIN_PLUS_HPP_
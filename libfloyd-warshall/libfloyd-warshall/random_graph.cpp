@@ -0,0 +1,47 @@
+#include <libfloyd-warshall/random_graph.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <random>
+
+void add_random_edges(i32* dist, u32 stride, u32 vertex_count, u32 edges_per_vertex, u64 seed)
+{
+   auto random_engine = std::mt19937_64(seed);
+   auto ends = std::uniform_int_distribution<u32>(0, vertex_count - 1);
+   auto weights = std::uniform_int_distribution<i32>(1, max_random_weight);
+
+   for (u32 i = 0; i < vertex_count; ++i)
+   {
+      i32* row = dist + std::size_t{i} * stride;
+
+      for (u32 e = 0; e < edges_per_vertex; ++e)
+      {
+         const u32 end = ends(random_engine);
+         if (end != i)
+         {
+            row[end] = std::min(row[end], weights(random_engine));
+         }
+      }
+   }
+}
+
+auto summarize_distances(const i32* dist, u32 stride, u32 vertex_count) -> distance_summary
+{
+   distance_summary summary;
+
+   for (u32 i = 0; i < vertex_count; ++i)
+   {
+      const i32* row = dist + std::size_t{i} * stride;
+
+      for (u32 j = 0; j < vertex_count; ++j)
+      {
+         if (j != i and reachable(row[j]))
+         {
+            ++summary.reachable_pairs;
+            summary.distance_sum += row[j];
+         }
+      }
+   }
+
+   return summary;
+}
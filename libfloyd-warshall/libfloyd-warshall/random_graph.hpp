@@ -0,0 +1,31 @@
+#ifndef LIBFLOYD_WARSHALL_RANDOM_GRAPH_HPP_
+#define LIBFLOYD_WARSHALL_RANDOM_GRAPH_HPP_
+
+#include <libfloyd-warshall/distance.hpp>
+#include <libfloyd-warshall/types.hpp>
+
+// Largest weight of the edges of add_random_edges().
+inline constexpr i32 max_random_weight = 100;
+
+// Most vertices of a random graph whose weights stay within max_edge_weight().
+inline constexpr u32 max_random_vertex_count =
+   static_cast<u32>((tombstone / 2 - 1) / max_random_weight) + 1;
+
+/**
+ * Adds `edges_per_vertex` edges of weight 1 to max_random_weight leaving each of the first
+ * `vertex_count` vertices of the row-major matrix `dist`, whose rows are `stride` apart. The
+ * same seed draws the same graph in both solvers, whatever their padding.
+ */
+void add_random_edges(i32* dist, u32 stride, u32 vertex_count, u32 edges_per_vertex, u64 seed);
+
+// What the solvers print of the distances of a random graph, too large to print, so that their
+// results can be compared.
+struct distance_summary
+{
+   u64 reachable_pairs = 0; // ordered pairs of distinct vertices with a path between them
+   i64 distance_sum = 0;    // sum of their distances
+};
+
+auto summarize_distances(const i32* dist, u32 stride, u32 vertex_count) -> distance_summary;
+
+#endif // LIBFLOYD_WARSHALL_RANDOM_GRAPH_HPP_
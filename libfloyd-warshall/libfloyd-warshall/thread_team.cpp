@@ -0,0 +1,78 @@
+#include <libfloyd-warshall/thread_team.hpp>
+
+#include <algorithm>
+
+thread_team::thread_team(u32 thread_count) :
+   m_size(std::max(thread_count, 1U)), m_round_start(m_size), m_round_end(m_size),
+   m_phase_end(m_size)
+{
+   // With fewer CPUs than members, for instance a rank bound to a single core by its launcher,
+   // pinning would stack members on the same CPU, so they are left to the scheduler.
+   const auto cpus = allowed_cpus();
+   const bool pinned = m_size > 1 and cpus.size() >= m_size;
+
+   if (pinned)
+   {
+      pin_current_thread(cpus[0]);
+   }
+
+   m_threads.reserve(m_size - 1);
+   for (u32 member = 1; member < m_size; ++member)
+   {
+      m_threads.emplace_back([this, member, cpu = pinned ? cpus[member] : -1] {
+         if (cpu >= 0)
+         {
+            pin_current_thread(cpu);
+         }
+
+         serve(member);
+      });
+   }
+}
+
+thread_team::~thread_team()
+{
+   m_stopping = true;
+   m_round_start.arrive_and_wait();
+
+   for (auto& thread : m_threads)
+   {
+      thread.join();
+   }
+}
+
+void thread_team::run(const std::function<void(u32)>& work)
+{
+   m_work = &work;
+
+   m_round_start.arrive_and_wait();
+   work(0);
+   m_round_end.arrive_and_wait();
+
+   m_work = nullptr;
+}
+
+void thread_team::sync()
+{
+   m_phase_end.arrive_and_wait();
+}
+
+auto thread_team::size() const noexcept -> u32
+{
+   return m_size;
+}
+
+void thread_team::serve(u32 member)
+{
+   while (true)
+   {
+      m_round_start.arrive_and_wait();
+      if (m_stopping)
+      {
+         return;
+      }
+
+      (*m_work)(member);
+      m_round_end.arrive_and_wait();
+   }
+}
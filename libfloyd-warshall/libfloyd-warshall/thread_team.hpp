@@ -0,0 +1,58 @@
+#ifndef LIBFLOYD_WARSHALL_THREAD_TEAM_HPP_
+#define LIBFLOYD_WARSHALL_THREAD_TEAM_HPP_
+
+#include <libfloyd-warshall/types.hpp>
+
+#include <libcpu-affinity/cpu_affinity.hpp>
+
+#include <barrier>
+#include <functional>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed set of threads that all run the same work, each on its own share. The calling thread
+ * takes part as member 0.
+ *
+ * When the process may run on at least as many CPUs as there are members, member m is pinned to
+ * the m-th of them and keeps it from one run() to the next, so the memory a member writes first,
+ * which the system places on the NUMA node of its CPU, stays local to the member that works on
+ * it. Every process pins within its own affinity mask: ranks sharing a node must each be bound
+ * to their own CPUs, with `--map-by socket --bind-to socket` for instance, or their members
+ * would be pinned to the same ones.
+ */
+class thread_team
+{
+public:
+   explicit thread_team(u32 thread_count);
+   thread_team(const thread_team&) = delete;
+   thread_team(thread_team&&) = delete;
+   ~thread_team();
+
+   auto operator=(const thread_team&) -> thread_team& = delete;
+   auto operator=(thread_team&&) -> thread_team& = delete;
+
+   // Runs `work(member)` on every member and returns once they are all done.
+   void run(const std::function<void(u32)>& work);
+
+   // Within run(), waits for every member to get there, between the phases of the work.
+   void sync();
+
+   [[nodiscard]] auto size() const noexcept -> u32;
+
+private:
+   void serve(u32 member);
+
+private:
+   u32 m_size;
+
+   const std::function<void(u32)>* m_work = nullptr;
+   bool m_stopping = false;
+
+   std::barrier<> m_round_start;
+   std::barrier<> m_round_end;
+   std::barrier<> m_phase_end;
+   std::vector<std::thread> m_threads;
+};
+
+#endif // LIBFLOYD_WARSHALL_THREAD_TEAM_HPP_
@@ -0,0 +1,12 @@
+#ifndef LIBFLOYD_WARSHALL_TYPES_HPP_
+#define LIBFLOYD_WARSHALL_TYPES_HPP_
+
+#include <cstdint>
+
+using i32 = std::int32_t;
+using i64 = std::int64_t;
+
+using u32 = std::uint32_t;
+using u64 = std::uint64_t;
+
+#endif // LIBFLOYD_WARSHALL_TYPES_HPP_
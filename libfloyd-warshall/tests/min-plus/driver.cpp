@@ -0,0 +1,173 @@
+#include <libfloyd-warshall/distance.hpp>
+#include <libfloyd-warshall/min_plus.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace
+{
+   // Floyd-Warshall over the rows of an n x n matrix with min_plus_row(), skipping the rows that
+   // cannot reach k as the solvers do.
+   void solve(std::vector<i32>& dist, u32 n)
+   {
+      for (u32 k = 0; k < n; ++k)
+      {
+         for (u32 i = 0; i < n; ++i)
+         {
+            const i32 through = dist[std::size_t{i} * n + k];
+            if (reachable(through))
+            {
+               min_plus_row(&dist[std::size_t{i} * n], &dist[std::size_t{k} * n], through, n);
+            }
+         }
+      }
+   }
+
+   // A chain 0 -> 1 -> ... -> n - 2 of edges of `weight`, and a last vertex no one reaches.
+   auto chain(u32 n, i32 weight) -> std::vector<i32>
+   {
+      auto dist = std::vector<i32>(std::size_t{n} * n, tombstone);
+      for (u32 i = 0; i < n; ++i)
+      {
+         dist[std::size_t{i} * n + i] = 0;
+         if (i + 2 < n)
+         {
+            dist[std::size_t{i} * n + i + 1] = weight;
+         }
+      }
+
+      return dist;
+   }
+
+   // Every kernel the host supports against the scalar update, over lengths and start offsets
+   // that leave partial vectors at both ends, with tombstones in both operands and in place
+   // updates.
+   auto check_kernels() -> bool
+   {
+      auto random_engine = std::mt19937_64(42);
+      auto distance = std::uniform_int_distribution<i32>(-1000, 1000);
+
+      auto values = std::vector<i32>(1043);
+      for (i32& value : values)
+      {
+         value = distance(random_engine) % 7 == 0 ? tombstone : distance(random_engine);
+      }
+
+      bool passed = true;
+      for (const auto& kernel : supported_min_plus_kernels())
+      {
+         for (const u32 first : {0, 1, 3})
+         {
+            for (const u32 count : {0, 1, 7, 8, 9, 15, 16, 17, 33, 64, 1024, 1039})
+            {
+               for (const i32 through : {0, -17, 250, tombstone / 2 - 1})
+               {
+                  const i32* row = values.data() + first;
+
+                  auto expected = std::vector<i32>(values.rbegin(), values.rbegin() + count);
+                  auto out = expected;
+                  auto in_place = std::vector<i32>(row, row + count);
+                  auto expected_in_place = in_place;
+                  min_plus_row_scalar(expected.data(), row, through, count);
+                  min_plus_row_scalar(expected_in_place.data(), expected_in_place.data(), through,
+                                      count);
+
+                  kernel.update(out.data(), row, through, count);
+                  kernel.update(in_place.data(), in_place.data(), through, count);
+
+                  if (out != expected or in_place != expected_in_place)
+                  {
+                     std::cerr << kernel.name << " differs from the scalar update over ["
+                               << first << ", " << first + count << ") through " << through
+                               << '\n';
+                     passed = false;
+                  }
+               }
+            }
+         }
+      }
+
+      // The scalar update itself, against the definition.
+      auto out = std::vector<i32>(values.rbegin(), values.rend());
+      auto expected = out;
+      for (std::size_t j = 0; j < values.size(); ++j)
+      {
+         expected[j] = std::min(expected[j], 250 + values[j]);
+      }
+      min_plus_row_scalar(out.data(), values.data(), 250, static_cast<u32>(values.size()));
+      if (out != expected)
+      {
+         std::cerr << "the scalar update differs from its definition\n";
+         passed = false;
+      }
+
+      auto dispatched = std::vector<i32>(values.rbegin(), values.rend());
+      min_plus_row(dispatched.data(), values.data(), 250, static_cast<u32>(values.size()));
+      if (dispatched != expected)
+      {
+         std::cerr << "min_plus_row (" << min_plus_kernel_name()
+                   << ") differs from the reference\n";
+         passed = false;
+      }
+
+      return passed;
+   }
+
+   // Paths as long as max_edge_weight() allows stay reachable, and unreachable distances pulled
+   // down by paths as negative stay unreachable.
+   auto check_distance_bound() -> bool
+   {
+      bool passed = true;
+      for (const u32 n : {2, 3, 64, 200})
+      {
+         const i32 weight = max_edge_weight(n);
+         const i32 longest = weight * static_cast<i32>(n - 2);
+
+         auto positive = chain(n, weight);
+         solve(positive, n);
+         auto negative = chain(n, -weight);
+         solve(negative, n);
+
+         const i32 last = static_cast<i32>(n - 1);
+         if (positive[n - 2] != longest or not reachable(positive[n - 2]) or
+             negative[n - 2] != -longest)
+         {
+            std::cerr << "the longest path of " << n << " vertices is not found\n";
+            passed = false;
+         }
+
+         for (u32 i = 0; i + 1 < n; ++i)
+         {
+            if (reachable(positive[std::size_t{i} * n + last]) or
+                reachable(negative[std::size_t{i} * n + last]) or
+                reachable(negative[std::size_t{i + 1} * n]))
+            {
+               std::cerr << "an unreachable vertex of " << n << " vertices is reachable\n";
+               passed = false;
+               break;
+            }
+         }
+      }
+
+      // A path of 2^28 is no sentinel.
+      if (max_edge_weight(2) < (i32{1} << 28) or not reachable(i32{1} << 28))
+      {
+         std::cerr << "the distances are bounded too tightly\n";
+         passed = false;
+      }
+
+      return passed;
+   }
+} // namespace
+
+auto main() -> int
+{
+   const bool kernel_passed = check_kernels();
+   const bool bound_passed = check_distance_bound();
+
+   return kernel_passed and bound_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
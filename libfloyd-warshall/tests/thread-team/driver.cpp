@@ -0,0 +1,47 @@
+#include <libfloyd-warshall/thread_team.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// Every member runs the work once per run(), and sync() makes the writes of one phase visible to
+// every member in the next, whether or not the members could be pinned.
+auto main() -> int
+{
+   bool passed = true;
+   for (const u32 thread_count : {1U, 3U, available_cpu_count(), 2 * available_cpu_count() + 1})
+   {
+      auto team = thread_team(thread_count);
+      const u32 size = team.size();
+
+      for (u32 round = 0; round < 3; ++round)
+      {
+         auto written = std::vector<u32>(size);
+         std::atomic<u32> mismatches = 0;
+         std::atomic<u32> calls = 0;
+
+         team.run([&](u32 member) {
+            ++calls;
+            written[member] = member + round;
+
+            team.sync();
+
+            const u32 neighbour = (member + 1) % size;
+            if (written[neighbour] != neighbour + round)
+            {
+               ++mismatches;
+            }
+         });
+
+         if (calls != size or mismatches != 0)
+         {
+            std::cerr << "a team of " << size << " ran " << calls << " members with "
+                      << mismatches << " stale reads\n";
+            passed = false;
+         }
+      }
+   }
+
+   return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
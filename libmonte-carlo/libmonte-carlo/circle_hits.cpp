@@ -0,0 +1,166 @@
+#include <libmonte-carlo/circle_hits.hpp>
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <immintrin.h>
+#   define LIBMONTE_CARLO_X86 1
+#endif
+
+namespace
+{
+   constexpr f64 radius_squared = circle_radius * circle_radius;
+
+   auto count_hits_scalar(const f64* xs, const f64* ys, u64 count) -> u64
+   {
+      u64 hits = 0;
+      for (u64 i = 0; i < count; ++i)
+      {
+         const f64 x_dir = circle_center - xs[i];
+         const f64 y_dir = circle_center - ys[i];
+
+         hits += static_cast<u64>(x_dir * x_dir + y_dir * y_dir <= radius_squared);
+      }
+
+      return hits;
+   }
+
+#if defined(LIBMONTE_CARLO_X86)
+   // The compare masks are all ones (-1) in lanes that hit, so subtracting them from an integer
+   // accumulator counts hits without branching.
+
+   __attribute__((target("sse2"))) auto count_hits_sse2(const f64* xs, const f64* ys, u64 count)
+      -> u64
+   {
+      const __m128d center = _mm_set1_pd(circle_center);
+      const __m128d max_distance = _mm_set1_pd(radius_squared);
+
+      __m128i hits = _mm_setzero_si128();
+
+      u64 i = 0;
+      for (; i + 2 <= count; i += 2)
+      {
+         const __m128d x_dir = _mm_sub_pd(center, _mm_loadu_pd(xs + i));
+         const __m128d y_dir = _mm_sub_pd(center, _mm_loadu_pd(ys + i));
+         const __m128d distance =
+            _mm_add_pd(_mm_mul_pd(x_dir, x_dir), _mm_mul_pd(y_dir, y_dir));
+
+         hits = _mm_sub_epi64(hits, _mm_castpd_si128(_mm_cmple_pd(distance, max_distance)));
+      }
+
+      alignas(16) u64 lanes[2];
+      _mm_store_si128(reinterpret_cast<__m128i*>(lanes), hits);
+
+      return lanes[0] + lanes[1] + count_hits_scalar(xs + i, ys + i, count - i);
+   }
+
+   __attribute__((target("avx2"))) auto count_hits_avx2(const f64* xs, const f64* ys, u64 count)
+      -> u64
+   {
+      const __m256d center = _mm256_set1_pd(circle_center);
+      const __m256d max_distance = _mm256_set1_pd(radius_squared);
+
+      __m256i hits = _mm256_setzero_si256();
+
+      u64 i = 0;
+      for (; i + 4 <= count; i += 4)
+      {
+         const __m256d x_dir = _mm256_sub_pd(center, _mm256_loadu_pd(xs + i));
+         const __m256d y_dir = _mm256_sub_pd(center, _mm256_loadu_pd(ys + i));
+         const __m256d distance =
+            _mm256_add_pd(_mm256_mul_pd(x_dir, x_dir), _mm256_mul_pd(y_dir, y_dir));
+         const __m256d mask = _mm256_cmp_pd(distance, max_distance, _CMP_LE_OQ);
+
+         hits = _mm256_sub_epi64(hits, _mm256_castpd_si256(mask));
+      }
+
+      alignas(32) u64 lanes[4];
+      _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), hits);
+
+      return lanes[0] + lanes[1] + lanes[2] + lanes[3] +
+         count_hits_scalar(xs + i, ys + i, count - i);
+   }
+
+   __attribute__((target("avx512f"))) auto count_hits_avx512(const f64* xs, const f64* ys,
+                                                               u64 count) -> u64
+   {
+      const __m512d center = _mm512_set1_pd(circle_center);
+      const __m512d max_distance = _mm512_set1_pd(radius_squared);
+      const __m512i one = _mm512_set1_epi64(1);
+
+      __m512i hits = _mm512_setzero_si512();
+
+      u64 i = 0;
+      for (; i + 8 <= count; i += 8)
+      {
+         const __m512d x_dir = _mm512_sub_pd(center, _mm512_loadu_pd(xs + i));
+         const __m512d y_dir = _mm512_sub_pd(center, _mm512_loadu_pd(ys + i));
+         const __m512d distance =
+            _mm512_add_pd(_mm512_mul_pd(x_dir, x_dir), _mm512_mul_pd(y_dir, y_dir));
+         const __mmask8 mask = _mm512_cmp_pd_mask(distance, max_distance, _CMP_LE_OQ);
+
+         hits = _mm512_mask_add_epi64(hits, mask, hits, one);
+      }
+
+      alignas(64) u64 lanes[8];
+      _mm512_store_si512(lanes, hits);
+
+      return lanes[0] + lanes[1] + lanes[2] + lanes[3] + lanes[4] + lanes[5] + lanes[6] +
+         lanes[7] + count_hits_scalar(xs + i, ys + i, count - i);
+   }
+#endif
+
+   auto find_supported_kernels() -> std::vector<circle_hits_kernel>
+   {
+      std::vector<circle_hits_kernel> kernels;
+
+#if defined(LIBMONTE_CARLO_X86)
+      __builtin_cpu_init();
+
+      if (__builtin_cpu_supports("avx512f"))
+      {
+         kernels.push_back({count_hits_avx512, "avx512"});
+      }
+      if (__builtin_cpu_supports("avx2"))
+      {
+         kernels.push_back({count_hits_avx2, "avx2"});
+      }
+      if (__builtin_cpu_supports("sse2"))
+      {
+         kernels.push_back({count_hits_sse2, "sse2"});
+      }
+#endif
+
+      kernels.push_back({count_hits_scalar, "scalar"});
+
+      return kernels;
+   }
+
+   auto active_kernel() -> const circle_hits_kernel&
+   {
+      return supported_circle_hits_kernels().front();
+   }
+} // namespace
+
+auto count_circle_hits(std::span<const f64> xs, std::span<const f64> ys) -> u64
+{
+   return active_kernel().count(xs.data(), ys.data(), std::min(xs.size(), ys.size()));
+}
+
+auto count_circle_hits_scalar(std::span<const f64> xs, std::span<const f64> ys) -> u64
+{
+   return count_hits_scalar(xs.data(), ys.data(), std::min(xs.size(), ys.size()));
+}
+
+auto circle_hits_kernel_name() -> std::string_view
+{
+   return active_kernel().name;
+}
+
+auto supported_circle_hits_kernels() -> std::span<const circle_hits_kernel>
+{
+   static const std::vector<circle_hits_kernel> kernels = find_supported_kernels();
+
+   return kernels;
+}
@@ -0,0 +1,48 @@
+#ifndef LIBMONTE_CARLO_CIRCLE_HITS_HPP_
+#define LIBMONTE_CARLO_CIRCLE_HITS_HPP_
+
+#include <libmonte-carlo/types.hpp>
+
+#include <span>
+#include <string_view>
+
+inline constexpr f64 circle_center = 0.5;
+inline constexpr f64 circle_radius = 0.5;
+
+// Number of samples classified per call to the hit kernel. Two blocks of coordinates stay
+// resident in L1.
+inline constexpr u64 sample_block_size = 1024;
+
+/**
+ * Counts how many of the points (xs[i], ys[i]) fall within the circle. Uses a squared distance
+ * compare and is dispatched at runtime to the widest of AVX-512, AVX2 or SSE2 supported by the
+ * host, with a scalar fallback.
+ */
+auto count_circle_hits(std::span<const f64> xs, std::span<const f64> ys) -> u64;
+
+/**
+ * Reference implementation of count_circle_hits, used for verification.
+ */
+auto count_circle_hits_scalar(std::span<const f64> xs, std::span<const f64> ys) -> u64;
+
+/**
+ * One implementation of count_circle_hits, for one instruction set.
+ */
+struct circle_hits_kernel
+{
+   u64 (*count)(const f64* xs, const f64* ys, u64 count);
+   std::string_view name;
+};
+
+/**
+ * Every kernel compiled in that the host supports, widest first; count_circle_hits runs the
+ * first one.
+ */
+auto supported_circle_hits_kernels() -> std::span<const circle_hits_kernel>;
+
+/**
+ * Name of the instruction set selected by count_circle_hits.
+ */
+auto circle_hits_kernel_name() -> std::string_view;
+
+#endif // LIBMONTE_CARLO_CIRCLE_HITS_HPP_
@@ -0,0 +1,426 @@
+#ifndef LIBMONTE_CARLO_MONTE_CARLO_HPP_
+#define LIBMONTE_CARLO_MONTE_CARLO_HPP_
+
+#include <libmonte-carlo/circle_hits.hpp>
+#include <libmonte-carlo/philox.hpp>
+#include <libmonte-carlo/running_statistics.hpp>
+#include <libmonte-carlo/sampling_team.hpp>
+#include <libmonte-carlo/sobol.hpp>
+#include <libmonte-carlo/types.hpp>
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <utility>
+
+// Monte Carlo integration over boxes of any dimension, built from three pieces chosen at compile
+// time so that the integrand inlines into the sampling loop:
+//
+// - a sampler fills blocks of uniform coordinates in [0, 1)^Dimension,
+// - a domain maps them onto the integration region, with a weight per sample,
+// - an integrand is evaluated at every mapped point.
+//
+// The integral is estimated batch by batch, each batch of `batch_size` samples yielding one
+// estimate, and the backends accumulate these estimates into running_statistics.
+
+namespace monte_carlo
+{
+   template <std::size_t Dimension>
+   using point = std::array<f64, Dimension>;
+
+   /**
+    * Coordinates of up to sample_block_size points, one contiguous array per dimension so that
+    * integrands and samplers can work on whole blocks with SIMD code.
+    */
+   template <std::size_t Dimension>
+   struct point_block
+   {
+      std::array<std::array<f64, sample_block_size>, Dimension> coordinates;
+      std::array<f64, sample_block_size> weights; // only set by domains without uniform weights
+      std::size_t size = 0;
+
+      [[nodiscard]] auto axis(std::size_t dimension) -> std::span<f64>
+      {
+         return {coordinates[dimension].data(), size};
+      }
+      [[nodiscard]] auto axis(std::size_t dimension) const -> std::span<const f64>
+      {
+         return {coordinates[dimension].data(), size};
+      }
+
+      [[nodiscard]] auto at(std::size_t i) const -> point<Dimension>
+      {
+         point<Dimension> x;
+         for (std::size_t d = 0; d < Dimension; ++d)
+         {
+            x[d] = coordinates[d][i];
+         }
+
+         return x;
+      }
+   };
+
+   template <typename F, std::size_t Dimension>
+   concept integrand = requires(const F& f, const point<Dimension>& x) {
+      { f(x) } -> std::convertible_to<f64>;
+   };
+
+   /**
+    * An integrand that can also sum itself over a whole block, for instance with a hand written
+    * SIMD kernel. The sum is only used when all samples carry the same weight.
+    */
+   template <typename F, std::size_t Dimension>
+   concept block_integrand = integrand<F, Dimension> and
+      requires(const F& f, const point_block<Dimension>& block) {
+         { f.sum(block) } -> std::convertible_to<f64>;
+      };
+
+   /**
+    * Fills the coordinates of the samples [offset, offset + block.size) of `batch` with uniform
+    * values in [0, 1). A batch must always receive the same values.
+    */
+   template <typename S, std::size_t Dimension>
+   concept sampler = requires(const S& s, u64 batch, u64 offset, point_block<Dimension>& block) {
+      s.fill(batch, offset, block);
+   };
+
+   /**
+    * Maps the uniform coordinates of the samples [offset, offset + block.size) of a batch onto
+    * the integration region in place, so that the mean of weight * f(x) over a batch estimates
+    * the integral. A domain whose samples all carry the same weight() says so through
+    * `uniform_weight`, the others set the weight of every sample in the block.
+    */
+   template <typename D, std::size_t Dimension>
+   concept domain = requires(const D& d, u64 offset, point_block<Dimension>& block) {
+      d.map(offset, block);
+      { D::uniform_weight } -> std::convertible_to<bool>;
+   } and (not D::uniform_weight or requires(const D& d) {
+      { d.weight() } -> std::convertible_to<f64>;
+   });
+
+   /**
+    * Independent Philox streams, one per batch: coordinate d of sample i is at position
+    * d * batch_size + i of the stream.
+    */
+   template <std::size_t Dimension>
+   class philox_sampler
+   {
+   public:
+      philox_sampler(u64 seed, u64 batch_size) : m_seed(seed), m_batch_size(batch_size) {}
+
+      void fill(u64 batch, u64 offset, point_block<Dimension>& block) const
+      {
+         const auto stream = philox_stream{.seed = m_seed, .batch = batch};
+
+         for (std::size_t d = 0; d < Dimension; ++d)
+         {
+            fill_uniform(stream, d * m_batch_size + offset, block.axis(d));
+         }
+      }
+
+   private:
+      u64 m_seed;
+      u64 m_batch_size;
+   };
+
+   /**
+    * The two dimensional scrambled Sobol sequence, batch b being the slice
+    * [b * batch_size, (b + 1) * batch_size) of it.
+    */
+   class sobol_sampler
+   {
+   public:
+      sobol_sampler(u64 seed, u64 batch_size) : m_seed(seed), m_batch_size(batch_size) {}
+
+      void fill(u64 batch, u64 offset, point_block<2>& block) const
+      {
+         auto sequence = sobol_2d(m_seed, batch * m_batch_size + offset);
+         sequence.fill(block.axis(0), block.axis(1));
+      }
+
+   private:
+      u64 m_seed;
+      u64 m_batch_size;
+   };
+
+   /**
+    * The box [lower, upper] split into strata_per_axis^Dimension equal cells, sample i of a batch
+    * being drawn in cell i % cell_count(). With batches made of a whole number of rounds over
+    * the cells every cell gets the same share of samples, and the estimate of a batch only
+    * carries the variance within the cells. One stratum per axis is plain uniform sampling.
+    */
+   template <std::size_t Dimension>
+   class stratified_box
+   {
+   public:
+      static constexpr bool uniform_weight = true;
+
+      stratified_box(point<Dimension> lower, point<Dimension> upper, u64 strata_per_axis = 1) :
+         m_lower(lower), m_strata_per_axis(strata_per_axis)
+      {
+         for (std::size_t d = 0; d < Dimension; ++d)
+         {
+            m_extent[d] = upper[d] - lower[d];
+            m_cell_extent[d] = m_extent[d] / static_cast<f64>(strata_per_axis);
+            m_volume *= m_extent[d];
+            m_cell_count *= strata_per_axis;
+            m_unit = m_unit and lower[d] == 0.0 and upper[d] == 1.0;
+         }
+      }
+
+      void map(u64 offset, point_block<Dimension>& block) const
+      {
+         if (m_strata_per_axis == 1)
+         {
+            // The unit cube needs no mapping at all.
+            if (m_unit)
+            {
+               return;
+            }
+
+            for (std::size_t d = 0; d < Dimension; ++d)
+            {
+               const f64 lower = m_lower[d];
+               const f64 extent = m_extent[d];
+
+               f64* coordinates = block.coordinates[d].data();
+               for (std::size_t i = 0; i < block.size; ++i)
+               {
+                  coordinates[i] = lower + extent * coordinates[i];
+               }
+            }
+
+            return;
+         }
+
+         // The digits of the cell index in base strata_per_axis, stepped like an odometer
+         // instead of divided out for every sample.
+         std::array<u64, Dimension> cell{};
+         u64 index = offset % m_cell_count;
+         for (std::size_t d = 0; d < Dimension; ++d)
+         {
+            cell[d] = index % m_strata_per_axis;
+            index /= m_strata_per_axis;
+         }
+
+         for (std::size_t i = 0; i < block.size; ++i)
+         {
+            for (std::size_t d = 0; d < Dimension; ++d)
+            {
+               f64& x = block.coordinates[d][i];
+               x = m_lower[d] + m_cell_extent[d] * (static_cast<f64>(cell[d]) + x);
+            }
+
+            for (std::size_t d = 0; d < Dimension and ++cell[d] == m_strata_per_axis; ++d)
+            {
+               cell[d] = 0;
+            }
+         }
+      }
+
+      [[nodiscard]] auto weight() const -> f64 { return m_volume; }
+      [[nodiscard]] auto cell_count() const -> u64 { return m_cell_count; }
+
+   private:
+      point<Dimension> m_lower;
+      point<Dimension> m_extent;
+      point<Dimension> m_cell_extent;
+      u64 m_strata_per_axis;
+      u64 m_cell_count = 1;
+      f64 m_volume = 1.0;
+      bool m_unit = true;
+   };
+
+   /**
+    * Draws points from a proposal distribution instead of uniformly. The proposal maps a point
+    * of [0, 1)^Dimension in place to a point of the region, typically by inverting its CDF, and
+    * returns its density there; the sample is then weighted by the inverse of that density.
+    */
+   template <typename P, std::size_t Dimension>
+   concept proposal = requires(const P& p, point<Dimension>& x) {
+      { p.transform(x) } -> std::convertible_to<f64>;
+   };
+
+   template <std::size_t Dimension, proposal<Dimension> Proposal>
+   class importance_sampling
+   {
+   public:
+      static constexpr bool uniform_weight = false;
+
+      explicit importance_sampling(Proposal proposal) : m_proposal(std::move(proposal)) {}
+
+      void map(u64 /* offset */, point_block<Dimension>& block) const
+      {
+         for (std::size_t i = 0; i < block.size; ++i)
+         {
+            auto x = block.at(i);
+            const f64 density = m_proposal.transform(x);
+
+            for (std::size_t d = 0; d < Dimension; ++d)
+            {
+               block.coordinates[d][i] = x[d];
+            }
+            block.weights[i] = 1.0 / density;
+         }
+      }
+
+   private:
+      Proposal m_proposal;
+   };
+
+   /**
+    * Estimates the integral of `Integrand` over a domain, one batch at a time. A batch is fully
+    * determined by its number, so batches can be sampled in any order and on any thread or rank.
+    */
+   template <std::size_t Dimension, integrand<Dimension> Integrand, sampler<Dimension> Sampler,
+             domain<Dimension> Domain>
+   class estimator
+   {
+   public:
+      static constexpr std::size_t dimension = Dimension;
+
+      estimator(Integrand integrand, Sampler sampler, Domain domain, u64 batch_size) :
+         m_integrand(std::move(integrand)), m_sampler(std::move(sampler)),
+         m_domain(std::move(domain)), m_batch_size(batch_size)
+      {}
+
+      /**
+       * Estimate of the integral given by the samples of `batch` alone.
+       */
+      [[nodiscard]] auto batch_value(u64 batch) const -> f64
+      {
+         point_block<Dimension> block;
+
+         f64 sum = 0.0;
+         for (u64 i = 0; i < m_batch_size; i += sample_block_size)
+         {
+            block.size = std::min(sample_block_size, m_batch_size - i);
+
+            m_sampler.fill(batch, i, block);
+            m_domain.map(i, block);
+
+            sum += block_sum(block);
+         }
+
+         return sum / static_cast<f64>(m_batch_size);
+      }
+
+      /**
+       * Accumulates the estimates of the batches [first_batch, first_batch + batch_count).
+       */
+      [[nodiscard]] auto sample(u64 first_batch, u64 batch_count) const -> running_statistics
+      {
+         running_statistics statistics;
+         for (u64 batch = first_batch; batch < first_batch + batch_count; ++batch)
+         {
+            statistics.add(batch_value(batch));
+         }
+
+         return statistics;
+      }
+
+      [[nodiscard]] auto batch_size() const -> u64 { return m_batch_size; }
+
+   private:
+      auto block_sum(const point_block<Dimension>& block) const -> f64
+      {
+         if constexpr (Domain::uniform_weight and block_integrand<Integrand, Dimension>)
+         {
+            return m_domain.weight() * static_cast<f64>(m_integrand.sum(block));
+         }
+         else if constexpr (Domain::uniform_weight)
+         {
+            f64 sum = 0.0;
+            for (std::size_t i = 0; i < block.size; ++i)
+            {
+               sum += static_cast<f64>(m_integrand(block.at(i)));
+            }
+
+            return m_domain.weight() * sum;
+         }
+         else
+         {
+            f64 sum = 0.0;
+            for (std::size_t i = 0; i < block.size; ++i)
+            {
+               sum += block.weights[i] * static_cast<f64>(m_integrand(block.at(i)));
+            }
+
+            return sum;
+         }
+      }
+
+   private:
+      Integrand m_integrand;
+      Sampler m_sampler;
+      Domain m_domain;
+      u64 m_batch_size;
+   };
+
+   /**
+    * Samples the batches on the calling thread.
+    */
+   template <typename Estimator>
+   class serial_backend
+   {
+   public:
+      explicit serial_backend(Estimator estimator) : m_estimator(std::move(estimator)) {}
+
+      auto sample(u64 first_batch, u64 batch_count) -> running_statistics
+      {
+         return m_estimator.sample(first_batch, batch_count);
+      }
+
+      [[nodiscard]] auto size() const noexcept -> u32 { return 1; }
+
+   private:
+      Estimator m_estimator;
+   };
+
+   /**
+    * Splits the batches between a team of pinned threads.
+    */
+   template <typename Estimator>
+   using threaded_backend = sampling_team<Estimator>;
+
+   /**
+    * Samples rounds of one batch per thread of `backend` until the confidence interval of the
+    * estimate is within `tolerance`.
+    */
+   template <typename Backend>
+   auto integrate(Backend& backend, f64 tolerance) -> running_statistics
+   {
+      const u64 batches_per_round = backend.size();
+
+      running_statistics statistics;
+      do
+      {
+         statistics.merge(backend.sample(statistics.count, batches_per_round));
+      } while (not is_converging(statistics, tolerance));
+
+      return statistics;
+   }
+
+   /**
+    * 4 times the indicator of the circle inscribed in the unit square, whose integral over the
+    * square is pi. Blocks are counted by the SIMD hit kernel.
+    */
+   struct circle_indicator
+   {
+      auto operator()(const point<2>& x) const -> f64
+      {
+         const f64 dx = x[0] - circle_center;
+         const f64 dy = x[1] - circle_center;
+
+         return dx * dx + dy * dy <= circle_radius * circle_radius ? 4.0 : 0.0;
+      }
+
+      [[nodiscard]] auto sum(const point_block<2>& block) const -> f64
+      {
+         return 4.0 * static_cast<f64>(count_circle_hits(block.axis(0), block.axis(1)));
+      }
+   };
+} // namespace monte_carlo
+
+#endif // LIBMONTE_CARLO_MONTE_CARLO_HPP_
@@ -0,0 +1,152 @@
+#ifndef LIBMONTE_CARLO_MONTE_CARLO_MPI_HPP_
+#define LIBMONTE_CARLO_MONTE_CARLO_MPI_HPP_
+
+#include <libmonte-carlo/running_statistics.hpp>
+#include <libmonte-carlo/sampling_team.hpp>
+#include <libmonte-carlo/types.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include <mpi.h>
+
+namespace monte_carlo
+{
+   /**
+    * What a rank contributes to the reduction of a round: the statistics of its batches and the
+    * time it spent sampling them and waiting on the previous reduction, which the overlapped mode
+    * sizes its rounds on. Reducing both in one collective keeps a single request per round.
+    */
+   struct round_statistics
+   {
+      running_statistics statistics;
+      u64 sampling_ns = 0;
+      u64 waiting_ns = 0;
+   };
+
+   /**
+    * MPI datatype of round_statistics and the operation merging the statistics and summing the
+    * timings, so that the batch estimates of all ranks are combined in a single reduction. Must
+    * be freed before MPI_Finalize.
+    */
+   struct statistics_reduction
+   {
+      MPI_Datatype type = MPI_DATATYPE_NULL;
+      MPI_Op op = MPI_OP_NULL;
+   };
+
+   inline auto make_statistics_reduction() -> statistics_reduction
+   {
+      constexpr std::size_t statistics = offsetof(round_statistics, statistics);
+
+      const std::array<int, 5> block_lengths = {1, 1, 1, 1, 1};
+      const std::array<MPI_Aint, 5> displacements = {
+         statistics + offsetof(running_statistics, count),
+         statistics + offsetof(running_statistics, mean),
+         statistics + offsetof(running_statistics, m2), offsetof(round_statistics, sampling_ns),
+         offsetof(round_statistics, waiting_ns)};
+      const std::array<MPI_Datatype, 5> types = {MPI_UINT64_T, MPI_DOUBLE, MPI_DOUBLE,
+                                                 MPI_UINT64_T, MPI_UINT64_T};
+
+      statistics_reduction reduction;
+
+      MPI_Datatype packed = MPI_DATATYPE_NULL;
+      MPI_Type_create_struct(5, block_lengths.data(), displacements.data(), types.data(),
+                             &packed);
+      MPI_Type_create_resized(packed, 0, sizeof(round_statistics), &reduction.type);
+      MPI_Type_commit(&reduction.type);
+      MPI_Type_free(&packed);
+
+      const auto merge = [](void* in, void* in_out, int* length, MPI_Datatype*) {
+         const auto* sources = static_cast<const round_statistics*>(in);
+         auto* targets = static_cast<round_statistics*>(in_out);
+
+         for (int i = 0; i < *length; ++i)
+         {
+            targets[i].statistics.merge(sources[i].statistics);
+            targets[i].sampling_ns += sources[i].sampling_ns;
+            targets[i].waiting_ns += sources[i].waiting_ns;
+         }
+      };
+
+      MPI_Op_create(merge, 1, &reduction.op);
+
+      return reduction;
+   }
+
+   inline void free_statistics_reduction(statistics_reduction& reduction)
+   {
+      MPI_Op_free(&reduction.op);
+      MPI_Type_free(&reduction.type);
+   }
+
+   /**
+    * Number of sampling threads every rank of `communicator` runs: `requested`, or when it is 0
+    * the fewest CPUs available to any rank. The global batch numbering relies on all the ranks
+    * sampling as many batches per round, so no rank may size its team on its own.
+    */
+   inline auto agreed_thread_count(u32 requested, MPI_Comm communicator) -> u32
+   {
+      u32 thread_count = requested == 0 ? available_cpu_count() : requested;
+      MPI_Allreduce(MPI_IN_PLACE, &thread_count, 1, MPI_UINT32_T, MPI_MIN, communicator);
+
+      return thread_count;
+   }
+
+   /**
+    * Spreads every call to sample() over the ranks of `communicator`, each rank sampling its
+    * contiguous share with the `Local` backend, and returns the statistics of all the ranks.
+    * Every rank must take part in every call, with the same arguments.
+    */
+   template <typename Local>
+   class mpi_backend
+   {
+   public:
+      mpi_backend(Local& local, const statistics_reduction& reduction, MPI_Comm communicator) :
+         m_local(local), m_reduction(reduction), m_communicator(communicator)
+      {
+         MPI_Comm_rank(communicator, &m_rank);
+         MPI_Comm_size(communicator, &m_rank_count);
+      }
+
+      auto sample(u64 first_batch, u64 batch_count) -> running_statistics
+      {
+         const auto rank = static_cast<u64>(m_rank);
+         const auto rank_count = static_cast<u64>(m_rank_count);
+
+         const u64 share = batch_count / rank_count;
+         const u64 extra = batch_count % rank_count;
+         const u64 first = first_batch + rank * share + std::min(rank, extra);
+         const u64 count = share + (rank < extra ? 1 : 0);
+
+         const round_statistics local_round = {.statistics = m_local.sample(first, count)};
+
+         round_statistics round;
+         MPI_Allreduce(&local_round, &round, 1, m_reduction.type, m_reduction.op,
+                       m_communicator);
+         ++m_reduction_count;
+
+         return round.statistics;
+      }
+
+      // Batches sampled in one round over all the ranks.
+      [[nodiscard]] auto size() const noexcept -> u64
+      {
+         return m_local.size() * static_cast<u64>(m_rank_count);
+      }
+
+      [[nodiscard]] auto reduction_count() const noexcept -> u64 { return m_reduction_count; }
+
+   private:
+      Local& m_local;
+      const statistics_reduction& m_reduction;
+      MPI_Comm m_communicator;
+
+      int m_rank = 0;
+      int m_rank_count = 1;
+      u64 m_reduction_count = 0;
+   };
+} // namespace monte_carlo
+
+#endif // LIBMONTE_CARLO_MONTE_CARLO_MPI_HPP_
@@ -0,0 +1,258 @@
+#include <libmonte-carlo/philox.hpp>
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(__i386__)
+#   include <immintrin.h>
+#   define LIBMONTE_CARLO_X86 1
+#endif
+
+namespace
+{
+   // Largest number of blocks produced by one call to a kernel.
+   constexpr u32 max_lane_count = 16;
+
+   // Writes 2 * lane_count doubles for the blocks [first_index, first_index + lane_count).
+   using kernel_fn = void (*)(const philox_stream&, u32, f64*);
+
+   constexpr u32 scalar_lane_count = 4;
+
+   void uniform_lanes_scalar(const philox_stream& stream, u32 first_index, f64* out)
+   {
+      for (u32 lane = 0; lane < scalar_lane_count; ++lane)
+      {
+         const auto block = philox_block(stream, first_index + lane);
+
+         out[2 * lane] = philox::to_unit_interval(block[1], block[0]);
+         out[2 * lane + 1] = philox::to_unit_interval(block[3], block[2]);
+      }
+   }
+
+#if defined(LIBMONTE_CARLO_X86)
+   constexpr u32 avx2_lane_count = 8;
+
+   // Returns the low and high halves of the 32x32 bit products of every lane of `a` with `m`.
+   __attribute__((target("avx2"))) inline void mul_hi_lo(__m256i a, __m256i m, __m256i& hi,
+                                                         __m256i& lo)
+   {
+      const __m256i even = _mm256_mul_epu32(a, m);
+      const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+
+      lo = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+      hi = _mm256_blend_epi32(_mm256_srli_epi64(even, 32), odd, 0xAA);
+   }
+
+   __attribute__((target("avx2"))) inline auto to_unit_interval(__m256i bits) -> __m256d
+   {
+      const __m256i exponent = _mm256_set1_epi64x(0x3FF0000000000000);
+      const __m256i mantissa = _mm256_or_si256(_mm256_srli_epi64(bits, 12), exponent);
+
+      return _mm256_sub_pd(_mm256_castsi256_pd(mantissa), _mm256_set1_pd(1.0));
+   }
+
+   __attribute__((target("avx2"))) void uniform_lanes_avx2(const philox_stream& stream,
+                                                           u32 first_index, f64* out)
+   {
+      const auto base = philox::make_counter(stream, first_index);
+      const auto key = philox::make_key(stream);
+
+      __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(base[0])),
+                                    _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+      __m256i c1 = _mm256_set1_epi32(static_cast<int>(base[1]));
+      __m256i c2 = _mm256_set1_epi32(static_cast<int>(base[2]));
+      __m256i c3 = _mm256_set1_epi32(static_cast<int>(base[3]));
+      __m256i k0 = _mm256_set1_epi32(static_cast<int>(key[0]));
+      __m256i k1 = _mm256_set1_epi32(static_cast<int>(key[1]));
+
+      const __m256i m0 = _mm256_set1_epi32(static_cast<int>(philox::multiplier_0));
+      const __m256i m1 = _mm256_set1_epi32(static_cast<int>(philox::multiplier_1));
+      const __m256i w0 = _mm256_set1_epi32(static_cast<int>(philox::weyl_0));
+      const __m256i w1 = _mm256_set1_epi32(static_cast<int>(philox::weyl_1));
+
+      for (u32 round = 0; round < philox::round_count; ++round)
+      {
+         __m256i hi0;
+         __m256i lo0;
+         __m256i hi1;
+         __m256i lo1;
+         mul_hi_lo(c0, m0, hi0, lo0);
+         mul_hi_lo(c2, m1, hi1, lo1);
+
+         c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), k0);
+         c1 = lo1;
+         c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), k1);
+         c3 = lo0;
+
+         k0 = _mm256_add_epi32(k0, w0);
+         k1 = _mm256_add_epi32(k1, w1);
+      }
+
+      // Pair the words of each block into 64-bit values; unpacking works within 128-bit halves,
+      // so `low` holds blocks {0, 1, 4, 5} and `high` holds blocks {2, 3, 6, 7}.
+      const __m256d x_low = to_unit_interval(_mm256_unpacklo_epi32(c0, c1));
+      const __m256d x_high = to_unit_interval(_mm256_unpackhi_epi32(c0, c1));
+      const __m256d y_low = to_unit_interval(_mm256_unpacklo_epi32(c2, c3));
+      const __m256d y_high = to_unit_interval(_mm256_unpackhi_epi32(c2, c3));
+
+      const __m256d blocks_04 = _mm256_unpacklo_pd(x_low, y_low);
+      const __m256d blocks_15 = _mm256_unpackhi_pd(x_low, y_low);
+      const __m256d blocks_26 = _mm256_unpacklo_pd(x_high, y_high);
+      const __m256d blocks_37 = _mm256_unpackhi_pd(x_high, y_high);
+
+      _mm256_storeu_pd(out, _mm256_permute2f128_pd(blocks_04, blocks_15, 0x20));
+      _mm256_storeu_pd(out + 4, _mm256_permute2f128_pd(blocks_26, blocks_37, 0x20));
+      _mm256_storeu_pd(out + 8, _mm256_permute2f128_pd(blocks_04, blocks_15, 0x31));
+      _mm256_storeu_pd(out + 12, _mm256_permute2f128_pd(blocks_26, blocks_37, 0x31));
+   }
+
+   constexpr u32 avx512_lane_count = 16;
+
+   __attribute__((target("avx512f"))) inline void mul_hi_lo(__m512i a, __m512i m, __m512i& hi,
+                                                            __m512i& lo)
+   {
+      const __m512i even = _mm512_mul_epu32(a, m);
+      const __m512i odd = _mm512_mul_epu32(_mm512_srli_epi64(a, 32), m);
+
+      lo = _mm512_mask_blend_epi32(0xAAAA, even, _mm512_slli_epi64(odd, 32));
+      hi = _mm512_mask_blend_epi32(0xAAAA, _mm512_srli_epi64(even, 32), odd);
+   }
+
+   __attribute__((target("avx512f"))) inline auto to_unit_interval(__m512i bits) -> __m512d
+   {
+      const __m512i exponent = _mm512_set1_epi64(0x3FF0000000000000);
+      const __m512i mantissa = _mm512_or_si512(_mm512_srli_epi64(bits, 12), exponent);
+
+      return _mm512_sub_pd(_mm512_castsi512_pd(mantissa), _mm512_set1_pd(1.0));
+   }
+
+   __attribute__((target("avx512f"))) void uniform_lanes_avx512(const philox_stream& stream,
+                                                                u32 first_index, f64* out)
+   {
+      const auto base = philox::make_counter(stream, first_index);
+      const auto key = philox::make_key(stream);
+
+      __m512i c0 = _mm512_add_epi32(
+         _mm512_set1_epi32(static_cast<int>(base[0])),
+         _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+      __m512i c1 = _mm512_set1_epi32(static_cast<int>(base[1]));
+      __m512i c2 = _mm512_set1_epi32(static_cast<int>(base[2]));
+      __m512i c3 = _mm512_set1_epi32(static_cast<int>(base[3]));
+      __m512i k0 = _mm512_set1_epi32(static_cast<int>(key[0]));
+      __m512i k1 = _mm512_set1_epi32(static_cast<int>(key[1]));
+
+      const __m512i m0 = _mm512_set1_epi32(static_cast<int>(philox::multiplier_0));
+      const __m512i m1 = _mm512_set1_epi32(static_cast<int>(philox::multiplier_1));
+      const __m512i w0 = _mm512_set1_epi32(static_cast<int>(philox::weyl_0));
+      const __m512i w1 = _mm512_set1_epi32(static_cast<int>(philox::weyl_1));
+
+      for (u32 round = 0; round < philox::round_count; ++round)
+      {
+         __m512i hi0;
+         __m512i lo0;
+         __m512i hi1;
+         __m512i lo1;
+         mul_hi_lo(c0, m0, hi0, lo0);
+         mul_hi_lo(c2, m1, hi1, lo1);
+
+         c0 = _mm512_xor_si512(_mm512_xor_si512(hi1, c1), k0);
+         c1 = lo1;
+         c2 = _mm512_xor_si512(_mm512_xor_si512(hi0, c3), k1);
+         c3 = lo0;
+
+         k0 = _mm512_add_epi32(k0, w0);
+         k1 = _mm512_add_epi32(k1, w1);
+      }
+
+      // As in the AVX2 kernel, `low` holds blocks {0, 1, 4, 5, 8, 9, 12, 13} and `high` the rest.
+      const __m512d x_low = to_unit_interval(_mm512_unpacklo_epi32(c0, c1));
+      const __m512d x_high = to_unit_interval(_mm512_unpackhi_epi32(c0, c1));
+      const __m512d y_low = to_unit_interval(_mm512_unpacklo_epi32(c2, c3));
+      const __m512d y_high = to_unit_interval(_mm512_unpackhi_epi32(c2, c3));
+
+      // Each 128-bit quarter now holds one block; a 4x4 transpose of quarters restores the order.
+      const __m512d blocks_0 = _mm512_unpacklo_pd(x_low, y_low);   // 0, 4, 8, 12
+      const __m512d blocks_1 = _mm512_unpackhi_pd(x_low, y_low);   // 1, 5, 9, 13
+      const __m512d blocks_2 = _mm512_unpacklo_pd(x_high, y_high); // 2, 6, 10, 14
+      const __m512d blocks_3 = _mm512_unpackhi_pd(x_high, y_high); // 3, 7, 11, 15
+
+      const __m512d blocks_0415 = _mm512_shuffle_f64x2(blocks_0, blocks_1, 0x44);
+      const __m512d blocks_8_12_9_13 = _mm512_shuffle_f64x2(blocks_0, blocks_1, 0xEE);
+      const __m512d blocks_2637 = _mm512_shuffle_f64x2(blocks_2, blocks_3, 0x44);
+      const __m512d blocks_10_14_11_15 = _mm512_shuffle_f64x2(blocks_2, blocks_3, 0xEE);
+
+      _mm512_storeu_pd(out, _mm512_shuffle_f64x2(blocks_0415, blocks_2637, 0x88));
+      _mm512_storeu_pd(out + 8, _mm512_shuffle_f64x2(blocks_0415, blocks_2637, 0xDD));
+      _mm512_storeu_pd(out + 16, _mm512_shuffle_f64x2(blocks_8_12_9_13, blocks_10_14_11_15, 0x88));
+      _mm512_storeu_pd(out + 24, _mm512_shuffle_f64x2(blocks_8_12_9_13, blocks_10_14_11_15, 0xDD));
+   }
+#endif
+
+   struct kernel_entry
+   {
+      kernel_fn fn;
+      u32 lane_count;
+      std::string_view name;
+   };
+
+   auto select_kernel() -> kernel_entry
+   {
+#if defined(LIBMONTE_CARLO_X86)
+      __builtin_cpu_init();
+
+      if (__builtin_cpu_supports("avx512f"))
+      {
+         return {uniform_lanes_avx512, avx512_lane_count, "avx512"};
+      }
+      if (__builtin_cpu_supports("avx2"))
+      {
+         return {uniform_lanes_avx2, avx2_lane_count, "avx2"};
+      }
+#endif
+
+      return {uniform_lanes_scalar, scalar_lane_count, "scalar"};
+   }
+
+   auto active_kernel() -> const kernel_entry&
+   {
+      static const kernel_entry kernel = select_kernel();
+
+      return kernel;
+   }
+} // namespace
+
+void fill_uniform(const philox_stream& stream, u64 offset, std::span<f64> out)
+{
+   const auto& kernel = active_kernel();
+   const u64 values_per_call = 2 * kernel.lane_count;
+
+   auto index = static_cast<u32>(offset / 2);
+   u64 skip = offset % 2;
+   u64 written = 0;
+
+   // Whole groups are written in place, a partial group at either end goes through `scratch`.
+   while (written < out.size())
+   {
+      if (skip == 0 and out.size() - written >= values_per_call)
+      {
+         kernel.fn(stream, index, out.data() + written);
+         written += values_per_call;
+      }
+      else
+      {
+         f64 scratch[2 * max_lane_count];
+         kernel.fn(stream, index, scratch);
+
+         const u64 count = std::min(values_per_call - skip, out.size() - written);
+         std::copy_n(scratch + skip, count, out.data() + written);
+         written += count;
+         skip = 0;
+      }
+
+      index += kernel.lane_count;
+   }
+}
+
+auto philox_kernel_name() -> std::string_view
+{
+   return active_kernel().name;
+}
@@ -0,0 +1,98 @@
+#ifndef LIBMONTE_CARLO_PHILOX_HPP_
+#define LIBMONTE_CARLO_PHILOX_HPP_
+
+#include <libmonte-carlo/types.hpp>
+
+#include <array>
+#include <bit>
+#include <span>
+#include <string_view>
+
+/**
+ * Identifies one independent stream of the Philox4x32-10 counter-based generator (Salmon et al.,
+ * "Parallel random numbers: as easy as 1, 2, 3"). The seed is the key, the remaining fields and
+ * the position within the stream form the counter, so any value of any stream can be computed
+ * directly without generating the ones before it.
+ */
+struct philox_stream
+{
+   u64 seed = 0;
+   u32 rank = 0;
+   u16 thread = 0;
+   u64 batch = 0; // only the low 48 bits are used
+};
+
+namespace philox
+{
+   inline constexpr u32 multiplier_0 = 0xD2511F53;
+   inline constexpr u32 multiplier_1 = 0xCD9E8D57;
+   inline constexpr u32 weyl_0 = 0x9E3779B9;
+   inline constexpr u32 weyl_1 = 0xBB67AE85;
+   inline constexpr u32 round_count = 10;
+
+   using block = std::array<u32, 4>;
+
+   inline auto mix(block counter, std::array<u32, 2> key) -> block
+   {
+      for (u32 round = 0; round < round_count; ++round)
+      {
+         const u64 product_0 = static_cast<u64>(multiplier_0) * counter[0];
+         const u64 product_1 = static_cast<u64>(multiplier_1) * counter[2];
+
+         counter = {static_cast<u32>(product_1 >> 32) ^ counter[1] ^ key[0],
+                    static_cast<u32>(product_1),
+                    static_cast<u32>(product_0 >> 32) ^ counter[3] ^ key[1],
+                    static_cast<u32>(product_0)};
+
+         key[0] += weyl_0;
+         key[1] += weyl_1;
+      }
+
+      return counter;
+   }
+
+   inline auto make_key(const philox_stream& stream) -> std::array<u32, 2>
+   {
+      return {static_cast<u32>(stream.seed), static_cast<u32>(stream.seed >> 32)};
+   }
+
+   inline auto make_counter(const philox_stream& stream, u32 index) -> block
+   {
+      return {index, static_cast<u32>(stream.batch),
+              static_cast<u32>((stream.batch >> 32) & 0xFFFF) |
+                 (static_cast<u32>(stream.thread) << 16),
+              stream.rank};
+   }
+
+   // Keeps the top 52 bits as the mantissa of a double in [1, 2), which vectorizes without an
+   // integer to floating point conversion.
+   inline auto to_unit_interval(u32 high, u32 low) -> f64
+   {
+      const u64 bits = (static_cast<u64>(high) << 32) | low;
+
+      return std::bit_cast<f64>((bits >> 12) | 0x3FF0000000000000) - 1.0;
+   }
+} // namespace philox
+
+/**
+ * Returns the `index`-th 128-bit output of `stream`.
+ */
+inline auto philox_block(const philox_stream& stream, u32 index) -> philox::block
+{
+   return philox::mix(philox::make_counter(stream, index), philox::make_key(stream));
+}
+
+/**
+ * Fills `out` with the uniform doubles in [0, 1) found at positions [offset, offset + out.size())
+ * of `stream`; the `index`-th block provides positions 2 * index and 2 * index + 1. Blocks are
+ * generated several at a time with the widest of AVX-512, AVX2 or plain scalar code supported by
+ * the host.
+ */
+void fill_uniform(const philox_stream& stream, u64 offset, std::span<f64> out);
+
+/**
+ * Name of the instruction set selected by fill_uniform.
+ */
+auto philox_kernel_name() -> std::string_view;
+
+#endif // LIBMONTE_CARLO_PHILOX_HPP_
@@ -0,0 +1,57 @@
+#include <libmonte-carlo/running_statistics.hpp>
+
+#include <cmath>
+#include <limits>
+
+void running_statistics::add(f64 value)
+{
+   ++count;
+
+   const f64 delta = value - mean;
+   mean += delta / static_cast<f64>(count);
+   m2 += delta * (value - mean);
+}
+
+void running_statistics::merge(const running_statistics& other)
+{
+   if (other.count == 0)
+   {
+      return;
+   }
+   if (count == 0)
+   {
+      *this = other;
+      return;
+   }
+
+   const auto count_a = static_cast<f64>(count);
+   const auto count_b = static_cast<f64>(other.count);
+   const f64 total = count_a + count_b;
+   const f64 delta = other.mean - mean;
+
+   // Symmetric in both operands, a.merge(b) and b.merge(a) agree bit for bit, so ranks that
+   // combine partial results in different orders still take the same decisions.
+   mean = (count_a * mean + count_b * other.mean) / total;
+   m2 = m2 + other.m2 + delta * delta * (count_a * count_b / total);
+   count += other.count;
+}
+
+auto running_statistics::variance() const -> f64
+{
+   return count < 2 ? 0.0 : m2 / static_cast<f64>(count - 1);
+}
+
+auto running_statistics::half_width() const -> f64
+{
+   if (count < 2)
+   {
+      return std::numeric_limits<f64>::infinity();
+   }
+
+   return confidence_z * std::sqrt(variance() / static_cast<f64>(count));
+}
+
+auto is_converging(const running_statistics& statistics, f64 tolerance) -> bool
+{
+   return statistics.count >= min_batch_count and statistics.half_width() <= tolerance;
+}
@@ -0,0 +1,40 @@
+#ifndef LIBMONTE_CARLO_RUNNING_STATISTICS_HPP_
+#define LIBMONTE_CARLO_RUNNING_STATISTICS_HPP_
+
+#include <libmonte-carlo/types.hpp>
+
+// z value of the two-sided 95% confidence interval reported by half_width().
+inline constexpr f64 confidence_z = 1.96;
+
+// The variance of fewer batches is too noisy to decide convergence on.
+inline constexpr u64 min_batch_count = 32;
+
+/**
+ * Count, mean and sum of squared deviations of a stream of values, updated with Welford's method
+ * so that the variance does not suffer from cancellation however many values are added. The
+ * accumulators of disjoint streams merge into the accumulator of their union.
+ */
+struct running_statistics
+{
+   u64 count = 0;
+   f64 mean = 0.0;
+   f64 m2 = 0.0;
+
+   void add(f64 value);
+   void merge(const running_statistics& other);
+
+   [[nodiscard]] auto variance() const -> f64;
+
+   /**
+    * Half-width of the confidence interval of the mean, infinite below two values.
+    */
+   [[nodiscard]] auto half_width() const -> f64;
+};
+
+/**
+ * Whether the confidence interval of the mean is within `tolerance` of it, once enough values
+ * have been seen for the variance to be trusted.
+ */
+auto is_converging(const running_statistics& statistics, f64 tolerance) -> bool;
+
+#endif // LIBMONTE_CARLO_RUNNING_STATISTICS_HPP_
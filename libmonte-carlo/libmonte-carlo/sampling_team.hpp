@@ -0,0 +1,160 @@
+#ifndef LIBMONTE_CARLO_SAMPLING_TEAM_HPP_
+#define LIBMONTE_CARLO_SAMPLING_TEAM_HPP_
+
+#include <libmonte-carlo/running_statistics.hpp>
+#include <libmonte-carlo/types.hpp>
+
+#include <libcpu-affinity/cpu_affinity.hpp>
+
+#include <algorithm>
+#include <barrier>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * A fixed set of threads that split the batches of every call to sample() between them. The
+ * calling thread takes part as the first member of the team, and each thread accumulates into its
+ * own cache line. When the process may run on at least as many CPUs as there are members, member
+ * m is pinned to the m-th of them; otherwise the members are left to the scheduler.
+ *
+ * `Estimator` provides `sample(first_batch, batch_count) const -> running_statistics` and is
+ * shared by all the threads.
+ */
+template <typename Estimator>
+class sampling_team
+{
+public:
+   sampling_team(Estimator estimator, u32 thread_count);
+   sampling_team(const sampling_team&) = delete;
+   sampling_team(sampling_team&&) = delete;
+   ~sampling_team();
+
+   auto operator=(const sampling_team&) -> sampling_team& = delete;
+   auto operator=(sampling_team&&) -> sampling_team& = delete;
+
+   auto sample(u64 first_batch, u64 batch_count) -> running_statistics;
+
+   [[nodiscard]] auto size() const noexcept -> u32;
+
+private:
+   static constexpr std::size_t cache_line_size = 64;
+
+   struct alignas(cache_line_size) thread_counter
+   {
+      running_statistics statistics;
+   };
+
+   void sample_share(u32 member);
+   void run(u32 member);
+
+private:
+   Estimator m_estimator;
+   u32 m_size;
+
+   u64 m_first_batch = 0;
+   u64 m_batch_count = 0;
+   bool m_stopping = false;
+
+   std::vector<thread_counter> m_counters;
+   std::barrier<> m_round_start;
+   std::barrier<> m_round_end;
+   std::vector<std::thread> m_threads;
+};
+
+template <typename Estimator>
+sampling_team<Estimator>::sampling_team(Estimator estimator, u32 thread_count) :
+   m_estimator(std::move(estimator)), m_size(std::max(thread_count, 1U)), m_counters(m_size),
+   m_round_start(m_size), m_round_end(m_size)
+{
+   // With fewer CPUs than members, for instance a rank bound to a single core by its launcher,
+   // pinning would stack members on the same CPU, so they are left to the scheduler.
+   const auto cpus = allowed_cpus();
+   const bool pinned = m_size > 1 and cpus.size() >= m_size;
+
+   if (pinned)
+   {
+      pin_current_thread(cpus[0]);
+   }
+
+   m_threads.reserve(m_size - 1);
+   for (u32 member = 1; member < m_size; ++member)
+   {
+      m_threads.emplace_back([this, member, cpu = pinned ? cpus[member] : -1] {
+         if (cpu >= 0)
+         {
+            pin_current_thread(cpu);
+         }
+
+         run(member);
+      });
+   }
+}
+
+template <typename Estimator>
+sampling_team<Estimator>::~sampling_team()
+{
+   m_stopping = true;
+   m_round_start.arrive_and_wait();
+
+   for (auto& thread : m_threads)
+   {
+      thread.join();
+   }
+}
+
+template <typename Estimator>
+auto sampling_team<Estimator>::sample(u64 first_batch, u64 batch_count) -> running_statistics
+{
+   m_first_batch = first_batch;
+   m_batch_count = batch_count;
+
+   m_round_start.arrive_and_wait();
+   sample_share(0);
+   m_round_end.arrive_and_wait();
+
+   // Merged in member order, which keeps the result identical from one run to the next.
+   running_statistics statistics;
+   for (const auto& counter : m_counters)
+   {
+      statistics.merge(counter.statistics);
+   }
+
+   return statistics;
+}
+
+template <typename Estimator>
+auto sampling_team<Estimator>::size() const noexcept -> u32
+{
+   return m_size;
+}
+
+template <typename Estimator>
+void sampling_team<Estimator>::sample_share(u32 member)
+{
+   // Contiguous shares, the first `batch_count % size` members take one extra batch.
+   const u64 share = m_batch_count / m_size;
+   const u64 extra = m_batch_count % m_size;
+   const u64 first = m_first_batch + member * share + std::min<u64>(member, extra);
+   const u64 count = share + (member < extra ? 1 : 0);
+
+   m_counters[member].statistics = m_estimator.sample(first, count);
+}
+
+template <typename Estimator>
+void sampling_team<Estimator>::run(u32 member)
+{
+   while (true)
+   {
+      m_round_start.arrive_and_wait();
+      if (m_stopping)
+      {
+         return;
+      }
+
+      sample_share(member);
+      m_round_end.arrive_and_wait();
+   }
+}
+
+#endif // LIBMONTE_CARLO_SAMPLING_TEAM_HPP_
@@ -0,0 +1,77 @@
+#include <libmonte-carlo/sobol.hpp>
+
+#include <libmonte-carlo/philox.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <limits>
+
+namespace
+{
+   constexpr u32 bit_count = 64;
+
+   using direction_numbers = std::array<u64, bit_count>;
+
+   // The first dimension is the van der Corput sequence in base 2. The second one uses the
+   // primitive polynomial x + 1 with m_1 = 1, as in the Joe & Kuo tables, whose recurrence
+   // reduces to v_k = v_(k-1) ^ (v_(k-1) >> 1).
+   constexpr auto make_directions(bool second_dimension) -> direction_numbers
+   {
+      direction_numbers directions{};
+
+      directions[0] = u64(1) << (bit_count - 1);
+      for (u32 k = 1; k < bit_count; ++k)
+      {
+         const u64 previous = directions[k - 1];
+         directions[k] = second_dimension ? previous ^ (previous >> 1) : previous >> 1;
+      }
+
+      return directions;
+   }
+
+   constexpr auto x_directions = make_directions(false);
+   constexpr auto y_directions = make_directions(true);
+
+   // Philox stream reserved for the digital shift, ranks never sample from it.
+   constexpr u32 scramble_rank = std::numeric_limits<u32>::max();
+
+   auto to_unit_interval(u64 bits) -> f64
+   {
+      return static_cast<f64>(bits >> 11) * 0x1.0p-53;
+   }
+} // namespace
+
+sobol_2d::sobol_2d(u64 seed, u64 first_index) : m_index(first_index)
+{
+   const auto shift = philox_block(philox_stream{.seed = seed, .rank = scramble_rank}, 0);
+
+   m_x = (static_cast<u64>(shift[1]) << 32) | shift[0];
+   m_y = (static_cast<u64>(shift[3]) << 32) | shift[2];
+
+   // Point n of the Gray code ordering combines the direction numbers of the bits of n ^ (n >> 1).
+   const u64 gray = first_index ^ (first_index >> 1);
+   for (u32 k = 0; k < bit_count; ++k)
+   {
+      if ((gray >> k) & 1)
+      {
+         m_x ^= x_directions[k];
+         m_y ^= y_directions[k];
+      }
+   }
+}
+
+void sobol_2d::fill(std::span<f64> xs, std::span<f64> ys)
+{
+   const std::size_t count = std::min(xs.size(), ys.size());
+   for (std::size_t i = 0; i < count; ++i)
+   {
+      xs[i] = to_unit_interval(m_x);
+      ys[i] = to_unit_interval(m_y);
+
+      // Consecutive Gray codes differ in the lowest set bit of the next index only.
+      const auto k = static_cast<u32>(std::countr_zero(++m_index));
+      m_x ^= x_directions[k];
+      m_y ^= y_directions[k];
+   }
+}
@@ -0,0 +1,30 @@
+#ifndef LIBMONTE_CARLO_SOBOL_HPP_
+#define LIBMONTE_CARLO_SOBOL_HPP_
+
+#include <libmonte-carlo/types.hpp>
+
+#include <span>
+
+/**
+ * The first two dimensions of the Sobol low-discrepancy sequence in Gray code order, scrambled
+ * with a random digital shift derived from the seed. Any point can be reached directly, so a
+ * batch is simply a contiguous slice of the sequence and the union of the first n batches is
+ * always the first n * batch size points, whichever ranks sampled them.
+ */
+class sobol_2d
+{
+public:
+   sobol_2d(u64 seed, u64 first_index);
+
+   /**
+    * Writes the next min(xs.size(), ys.size()) points, as doubles in [0, 1).
+    */
+   void fill(std::span<f64> xs, std::span<f64> ys);
+
+private:
+   u64 m_index;
+   u64 m_x;
+   u64 m_y;
+};
+
+#endif // LIBMONTE_CARLO_SOBOL_HPP_
@@ -0,0 +1,11 @@
+#ifndef LIBMONTE_CARLO_TYPES_HPP_
+#define LIBMONTE_CARLO_TYPES_HPP_
+
+#include <cstdint>
+
+using u16 = std::uint16_t;
+using u32 = std::uint32_t;
+using u64 = std::uint64_t;
+using f64 = double;
+
+#endif // LIBMONTE_CARLO_TYPES_HPP_
@@ -0,0 +1,63 @@
+#include <libmonte-carlo/circle_hits.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Every kernel the host supports against count_circle_hits_scalar, over lengths and start
+// offsets that leave partial vectors at both ends, with points on and around the circle.
+auto main() -> int
+{
+   auto random_engine = std::mt19937_64(42);
+   auto coordinate = std::uniform_real_distribution<f64>(0.0, 1.0);
+
+   auto xs = std::vector<f64>(1043);
+   auto ys = std::vector<f64>(xs.size());
+   for (std::size_t i = 0; i < xs.size(); ++i)
+   {
+      xs[i] = coordinate(random_engine);
+      ys[i] = coordinate(random_engine);
+   }
+
+   // Exactly on the circle, which counts as a hit, and at the corners of the square.
+   xs[5] = circle_center + circle_radius;
+   ys[5] = circle_center;
+   xs[6] = circle_center;
+   ys[6] = circle_center - circle_radius;
+   xs[7] = 0.0;
+   ys[7] = 0.0;
+   xs[8] = 1.0;
+   ys[8] = 1.0;
+
+   bool passed = true;
+   for (const auto& kernel : supported_circle_hits_kernels())
+   {
+      for (const std::size_t first : {0, 1, 3})
+      {
+         for (const std::size_t count : {0, 1, 7, 8, 9, 17, 1024, 1040})
+         {
+            const auto x_span = std::span<const f64>(xs).subspan(first, count);
+            const auto y_span = std::span<const f64>(ys).subspan(first, count);
+
+            const u64 expected = count_circle_hits_scalar(x_span, y_span);
+            const u64 hits = kernel.count(x_span.data(), y_span.data(), count);
+            if (hits != expected)
+            {
+               std::cerr << kernel.name << " counts " << hits << " hits instead of " << expected
+                         << " over [" << first << ", " << first + count << ")\n";
+               passed = false;
+            }
+         }
+      }
+   }
+
+   if (count_circle_hits(xs, ys) != count_circle_hits_scalar(xs, ys))
+   {
+      std::cerr << "count_circle_hits (" << circle_hits_kernel_name()
+                << ") differs from the reference\n";
+      passed = false;
+   }
+
+   return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
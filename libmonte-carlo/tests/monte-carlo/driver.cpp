@@ -0,0 +1,244 @@
+#include <libmonte-carlo/monte_carlo.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <numbers>
+#include <random>
+#include <span>
+#include <vector>
+
+namespace
+{
+   constexpr u64 batch_size = 1000;
+   constexpr u64 seed = 7;
+
+   struct cubic
+   {
+      auto operator()(const monte_carlo::point<1>& x) const -> f64 { return 3.0 * x[0] * x[0]; }
+   };
+
+   // Density 2x on (0, 1], drawn by inverting its CDF x^2. 1 - u keeps x away from 0.
+   struct linear_proposal
+   {
+      auto transform(monte_carlo::point<1>& x) const -> f64
+      {
+         x[0] = std::sqrt(1.0 - x[0]);
+
+         return 2.0 * x[0];
+      }
+   };
+
+   auto check(bool condition, const char* message) -> bool
+   {
+      if (not condition)
+      {
+         std::cerr << message << '\n';
+      }
+
+      return condition;
+   }
+
+   // The serial backend converges on pi, and gives the estimate of the batches it sampled.
+   auto check_serial_backend() -> bool
+   {
+      const auto estimator =
+         monte_carlo::estimator<2, monte_carlo::circle_indicator, monte_carlo::philox_sampler<2>,
+                                monte_carlo::stratified_box<2>>(
+            {}, {seed, batch_size}, {{0.0, 0.0}, {1.0, 1.0}}, batch_size);
+
+      auto backend = monte_carlo::serial_backend(estimator);
+      const auto statistics = monte_carlo::integrate(backend, 0.01);
+      const auto batches = estimator.sample(0, statistics.count);
+
+      return check(backend.size() == 1, "the serial backend has more than one member") and
+         check(statistics.half_width() <= 0.01, "integrate stopped before converging") and
+         check(std::abs(statistics.mean - std::numbers::pi) <= 0.03, "pi is out of bounds") and
+         check(std::abs(statistics.mean - batches.mean) <= 1e-12,
+               "the serial backend estimates other batches");
+   }
+
+   // A team of threads samples the same batches as the calling thread alone.
+   auto check_threaded_backend() -> bool
+   {
+      const auto estimator =
+         monte_carlo::estimator<2, monte_carlo::circle_indicator, monte_carlo::philox_sampler<2>,
+                                monte_carlo::stratified_box<2>>(
+            {}, {seed, batch_size}, {{0.0, 0.0}, {1.0, 1.0}}, batch_size);
+
+      auto serial = monte_carlo::serial_backend(estimator);
+      auto team = monte_carlo::threaded_backend<decltype(estimator)>(estimator, 3);
+
+      const auto expected = serial.sample(5, 40);
+      const auto statistics = team.sample(5, 40);
+
+      // A team wider than the CPUs of the process pins nothing, the calling thread included.
+      const auto cpus = allowed_cpus();
+      auto wide_team =
+         monte_carlo::threaded_backend<decltype(estimator)>(estimator, available_cpu_count() + 1);
+      const auto wide_statistics = wide_team.sample(5, 40);
+
+      return check(statistics.count == expected.count, "the team samples another batch count") and
+         check(std::abs(statistics.mean - expected.mean) <= 1e-12,
+               "the team estimates other batches") and
+         check(std::abs(wide_statistics.mean - expected.mean) <= 1e-12,
+               "a team wider than the CPUs estimates other batches") and
+         check(allowed_cpus() == cpus, "a team wider than the CPUs pins the calling thread");
+   }
+
+   // Sample i of a batch lands in cell i % cell_count(), the cells counted with the first axis
+   // fastest, and a stratified estimate only keeps the variance within the cells.
+   auto check_stratified_box() -> bool
+   {
+      const auto box = monte_carlo::stratified_box<2>({-1.0, 2.0}, {1.0, 5.0}, 3);
+
+      constexpr u64 offset = 7;
+      monte_carlo::point_block<2> block;
+      block.size = 20;
+      for (std::size_t i = 0; i < block.size; ++i)
+      {
+         block.coordinates[0][i] = 0.5;
+         block.coordinates[1][i] = 0.25;
+      }
+      box.map(offset, block);
+
+      bool in_cells = true;
+      for (std::size_t i = 0; i < block.size; ++i)
+      {
+         const u64 cell = (offset + i) % box.cell_count();
+         const f64 x = -1.0 + (2.0 / 3.0) * (static_cast<f64>(cell % 3) + 0.5);
+         const f64 y = 2.0 + 1.0 * (static_cast<f64>(cell / 3) + 0.25);
+
+         in_cells = in_cells and std::abs(block.coordinates[0][i] - x) <= 1e-12 and
+            std::abs(block.coordinates[1][i] - y) <= 1e-12;
+      }
+
+      // 16 x 16 strata over the circle indicator, batches of 4 rounds over the cells.
+      constexpr u64 strata = 16;
+      constexpr u64 stratified_batch_size = 4 * strata * strata;
+      const auto stratified =
+         monte_carlo::estimator<2, monte_carlo::circle_indicator, monte_carlo::philox_sampler<2>,
+                                monte_carlo::stratified_box<2>>(
+            {}, {seed, stratified_batch_size}, {{0.0, 0.0}, {1.0, 1.0}, strata},
+            stratified_batch_size);
+      const auto uniform =
+         monte_carlo::estimator<2, monte_carlo::circle_indicator, monte_carlo::philox_sampler<2>,
+                                monte_carlo::stratified_box<2>>(
+            {}, {seed, stratified_batch_size}, {{0.0, 0.0}, {1.0, 1.0}},
+            stratified_batch_size);
+
+      const auto stratified_statistics = stratified.sample(0, 200);
+      const auto uniform_statistics = uniform.sample(0, 200);
+
+      return check(box.cell_count() == 9, "3 strata per axis do not make 9 cells") and
+         check(std::abs(box.weight() - 6.0) <= 1e-12, "the box has the wrong volume") and
+         check(in_cells, "samples land outside their cell") and
+         check(std::abs(stratified_statistics.mean - std::numbers::pi) <= 0.01,
+               "the stratified estimate of pi is out of bounds") and
+         check(stratified_statistics.variance() < 0.25 * uniform_statistics.variance(),
+               "stratification does not reduce the variance");
+   }
+
+   // Starting the sequence anywhere gives the points stepping to there would, however the
+   // points are split between calls to fill().
+   auto check_sobol_jump_ahead() -> bool
+   {
+      constexpr std::size_t point_count = 1000;
+
+      auto xs = std::vector<f64>(point_count);
+      auto ys = std::vector<f64>(point_count);
+      auto sequence = sobol_2d(seed, 0);
+      for (std::size_t first = 0; first < point_count; first += 13)
+      {
+         const std::size_t count = std::min<std::size_t>(13, point_count - first);
+         sequence.fill(std::span(xs).subspan(first, count), std::span(ys).subspan(first, count));
+      }
+
+      bool passed = true;
+      for (const u64 first_index : {0, 1, 7, 64, 511, 512, 999})
+      {
+         const std::size_t count = point_count - first_index;
+         auto jumped_xs = std::vector<f64>(count);
+         auto jumped_ys = std::vector<f64>(count);
+         sobol_2d(seed, first_index).fill(jumped_xs, jumped_ys);
+
+         passed = passed and
+            std::equal(jumped_xs.begin(), jumped_xs.end(), xs.begin() + first_index) and
+            std::equal(jumped_ys.begin(), jumped_ys.end(), ys.begin() + first_index);
+      }
+
+      return check(passed, "jumping ahead in the Sobol sequence gives other points");
+   }
+
+   // Merging the accumulators of the chunks of a stream, empty ones included, gives the
+   // accumulator of the whole stream.
+   auto check_statistics_merge() -> bool
+   {
+      auto random_engine = std::mt19937_64(seed);
+      auto value = std::normal_distribution<f64>(1e6, 3.0);
+
+      running_statistics single_pass;
+      running_statistics merged;
+      for (const std::size_t chunk_size : {0, 1, 2, 17, 0, 1000, 3, 1})
+      {
+         running_statistics chunk;
+         for (std::size_t i = 0; i < chunk_size; ++i)
+         {
+            const f64 x = value(random_engine);
+            single_pass.add(x);
+            chunk.add(x);
+         }
+
+         merged.merge(chunk);
+      }
+
+      return check(merged.count == single_pass.count, "merging loses values") and
+         check(std::abs(merged.mean - single_pass.mean) <= 1e-9,
+               "merging gives another mean") and
+         check(std::abs(merged.m2 - single_pass.m2) <= 1e-9 * single_pass.m2,
+               "merging gives another variance");
+   }
+
+   // The integral of 3x^2 over [0, 1] is 1. Drawn with density 2x, f / p = 1.5x has a variance of
+   // 1/8 against 4/5 for uniform draws, which the batch estimates must show.
+   auto check_importance_sampling() -> bool
+   {
+      using proposal_domain = monte_carlo::importance_sampling<1, linear_proposal>;
+
+      const auto importance =
+         monte_carlo::estimator<1, cubic, monte_carlo::philox_sampler<1>, proposal_domain>(
+            {}, {seed, batch_size}, proposal_domain({}), batch_size);
+      const auto uniform =
+         monte_carlo::estimator<1, cubic, monte_carlo::philox_sampler<1>,
+                                monte_carlo::stratified_box<1>>({}, {seed, batch_size},
+                                                                {{0.0}, {1.0}}, batch_size);
+
+      auto backend = monte_carlo::serial_backend(importance);
+      const auto statistics = monte_carlo::integrate(backend, 1e-3);
+
+      const f64 importance_variance = importance.sample(0, 200).variance() * batch_size;
+      const f64 uniform_variance = uniform.sample(0, 200).variance() * batch_size;
+
+      return check(std::abs(statistics.mean - 1.0) <= 3e-3, "the integral is out of bounds") and
+         check(std::abs(importance_variance - 0.125) <= 0.02,
+               "importance sampling has the wrong variance") and
+         check(std::abs(uniform_variance - 0.8) <= 0.1, "uniform sampling has the wrong variance");
+   }
+} // namespace
+
+auto main() -> int
+{
+   const bool serial_passed = check_serial_backend();
+   const bool threaded_passed = check_threaded_backend();
+   const bool importance_passed = check_importance_sampling();
+   const bool stratified_passed = check_stratified_box();
+   const bool sobol_passed = check_sobol_jump_ahead();
+   const bool merge_passed = check_statistics_merge();
+
+   return serial_passed and threaded_passed and importance_passed and stratified_passed and
+         sobol_passed and merge_passed
+      ? EXIT_SUCCESS
+      : EXIT_FAILURE;
+}
@@ -0,0 +1,87 @@
+#include <libmonte-carlo/philox.hpp>
+
+#include <array>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+   struct known_answer
+   {
+      philox::block counter;
+      std::array<u32, 2> key;
+      philox::block expected;
+   };
+
+   // Philox4x32-10 vectors of the Random123 known-answer tests (kat_vectors).
+   constexpr std::array<known_answer, 3> known_answers = {{
+      {{0x00000000, 0x00000000, 0x00000000, 0x00000000},
+       {0x00000000, 0x00000000},
+       {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8}},
+      {{0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff},
+       {0xffffffff, 0xffffffff},
+       {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd}},
+      {{0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+       {0xa4093822, 0x299f31d0},
+       {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1}},
+   }};
+
+   auto check_known_answers() -> bool
+   {
+      bool passed = true;
+      for (const auto& answer : known_answers)
+      {
+         if (philox::mix(answer.counter, answer.key) != answer.expected)
+         {
+            std::cerr << "philox::mix differs from the known answer for counter " << std::hex
+                      << answer.counter[0] << std::dec << '\n';
+            passed = false;
+         }
+      }
+
+      return passed;
+   }
+
+   // fill_uniform(), whichever kernel it runs, against the scalar blocks, from offsets that start
+   // and end within a block and a batch of blocks.
+   auto check_fill_uniform() -> bool
+   {
+      const auto stream = philox_stream{.seed = 0x0123456789abcdef, .rank = 3, .thread = 5,
+                                        .batch = 0x0000beefcafe1234};
+
+      bool passed = true;
+      for (const u64 offset : {u64{0}, u64{1}, u64{7}, u64{33}})
+      {
+         auto values = std::vector<f64>(1001);
+         fill_uniform(stream, offset, values);
+
+         for (u64 i = 0; i < values.size(); ++i)
+         {
+            const u64 position = offset + i;
+            const auto block = philox_block(stream, static_cast<u32>(position / 2));
+            const f64 expected = position % 2 == 0
+               ? philox::to_unit_interval(block[1], block[0])
+               : philox::to_unit_interval(block[3], block[2]);
+
+            if (values[i] != expected)
+            {
+               std::cerr << "fill_uniform (" << philox_kernel_name() << ") differs at position "
+                         << position << '\n';
+               passed = false;
+               break;
+            }
+         }
+      }
+
+      return passed;
+   }
+} // namespace
+
+auto main() -> int
+{
+   const bool known_answers_passed = check_known_answers();
+   const bool fill_uniform_passed = check_fill_uniform();
+
+   return known_answers_passed and fill_uniform_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,130 @@
+#ifndef LIBQSORT_INTEGER_SORT_HPP_
+#define LIBQSORT_INTEGER_SORT_HPP_
+
+#include <libqsort/introsort.hpp>
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace detail
+{
+   inline constexpr int radix_bits = 8;
+   inline constexpr std::size_t radix = std::size_t{1} << radix_bits;
+
+   // The distance of `value` from `min`, which orders signed keys correctly and leaves the high
+   // digits of narrow ranges at zero.
+   template <std::integral T>
+   constexpr auto key_offset(T value, T min) noexcept -> std::make_unsigned_t<T>
+   {
+      using key_type = std::make_unsigned_t<T>;
+
+      return static_cast<key_type>(static_cast<key_type>(value) - static_cast<key_type>(min));
+   }
+
+   // Counts every key of `[min, min + span]` and writes them back in order.
+   template <typename It, typename T>
+   void counting_sort(It beg, It end, T min, std::make_unsigned_t<T> span)
+   {
+      auto counts = std::vector<std::size_t>(static_cast<std::size_t>(span) + 1, 0);
+      for (auto i = beg; i != end; ++i)
+      {
+         ++counts[key_offset<T>(*i, min)];
+      }
+
+      auto out = beg;
+      for (std::size_t offset = 0; offset < counts.size(); ++offset)
+      {
+         out = std::fill_n(out, counts[offset], static_cast<T>(min + static_cast<T>(offset)));
+      }
+   }
+
+   // One stable scatter of `[first, last)` into `out` by the digit of the key offsets at `shift`.
+   template <typename InIt, typename OutIt, typename T>
+   void radix_pass(InIt first, InIt last, OutIt out, T min, int shift)
+   {
+      std::array<std::size_t, radix + 1> offsets = {};
+      for (auto i = first; i != last; ++i)
+      {
+         ++offsets[((key_offset<T>(*i, min) >> shift) & (radix - 1)) + 1];
+      }
+      for (std::size_t digit = 1; digit <= radix; ++digit)
+      {
+         offsets[digit] += offsets[digit - 1];
+      }
+
+      for (auto i = first; i != last; ++i)
+      {
+         out[offsets[(key_offset<T>(*i, min) >> shift) & (radix - 1)]++] = *i;
+      }
+   }
+
+   // Least significant digit first, skipping the high digits that are zero for every key.
+   template <typename It, typename T>
+   void lsd_radix_sort(It beg, It end, T min, std::make_unsigned_t<T> span)
+   {
+      auto buffer = std::vector<T>(static_cast<std::size_t>(std::distance(beg, end)));
+
+      bool in_buffer = false;
+      for (int shift = 0; shift < std::numeric_limits<std::make_unsigned_t<T>>::digits and
+                          (span >> shift) != 0;
+           shift += radix_bits)
+      {
+         if (in_buffer)
+         {
+            radix_pass(buffer.begin(), buffer.end(), beg, min, shift);
+         }
+         else
+         {
+            radix_pass(beg, end, buffer.begin(), min, shift);
+         }
+
+         in_buffer = not in_buffer;
+      }
+
+      if (in_buffer)
+      {
+         std::copy(buffer.begin(), buffer.end(), beg);
+      }
+   }
+} // namespace detail
+
+/**
+ * Sorts integers in O(n) passes over `[beg, end)`: a counting sort when the range of the keys is
+ * no wider than their number, an LSD radix sort on 8-bit digits of the offsets from the smallest
+ * key otherwise, which takes one pass per significant byte of the range. Small inputs go to
+ * insertion sort.
+ */
+template <std::random_access_iterator It>
+   requires std::integral<std::iter_value_t<It>>
+void integer_sort(It beg, It end)
+{
+   using value_type = std::iter_value_t<It>;
+
+   const auto size = static_cast<std::size_t>(std::distance(beg, end));
+   if (size <= static_cast<std::size_t>(detail::insertion_sort_cutoff))
+   {
+      detail::insertion_sort(beg, end, std::less<>{});
+      return;
+   }
+
+   const auto [min, max] = std::minmax_element(beg, end);
+   const value_type lowest = *min;
+   const auto span = detail::key_offset<value_type>(*max, lowest);
+
+   if (span < size)
+   {
+      detail::counting_sort(beg, end, lowest, span);
+   }
+   else
+   {
+      detail::lsd_radix_sort(beg, end, lowest, span);
+   }
+}
+
+#endif // LIBQSORT_INTEGER_SORT_HPP_
@@ -0,0 +1,173 @@
+#ifndef LIBQSORT_INTROSORT_HPP_
+#define LIBQSORT_INTROSORT_HPP_
+
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <iterator>
+#include <utility>
+
+namespace detail
+{
+   // Below this many elements, insertion sort beats another partitioning step.
+   inline constexpr std::ptrdiff_t insertion_sort_cutoff = 24;
+   // From this many elements on, the pivot is the median of three medians of three.
+   inline constexpr std::ptrdiff_t ninther_threshold = 128;
+
+   template <typename It, typename Compare>
+   void insertion_sort(It beg, It end, Compare comp)
+   {
+      if (beg == end)
+      {
+         return;
+      }
+
+      for (auto i = std::next(beg); i != end; ++i)
+      {
+         auto value = std::move(*i);
+         auto hole = i;
+         while (hole != beg and comp(value, *std::prev(hole)))
+         {
+            *hole = std::move(*std::prev(hole));
+            --hole;
+         }
+         *hole = std::move(value);
+      }
+   }
+
+   template <typename It, typename Compare>
+   void heap_sort(It beg, It end, Compare comp)
+   {
+      std::make_heap(beg, end, comp);
+      std::sort_heap(beg, end, comp);
+   }
+
+   // Leaves the median of `*a`, `*b` and `*c` in `*b`.
+   template <typename It, typename Compare>
+   void sort_three(It a, It b, It c, Compare comp)
+   {
+      if (comp(*b, *a))
+      {
+         std::iter_swap(a, b);
+      }
+      if (comp(*c, *b))
+      {
+         std::iter_swap(b, c);
+         if (comp(*b, *a))
+         {
+            std::iter_swap(a, b);
+         }
+      }
+   }
+
+   // Moves the chosen pivot to the first position of the range.
+   template <typename It, typename Compare>
+   void select_pivot(It beg, It end, Compare comp)
+   {
+      const auto size = std::distance(beg, end);
+      const auto mid = beg + size / 2;
+      const auto last = std::prev(end);
+
+      if (size >= ninther_threshold)
+      {
+         const auto step = size / 8;
+         sort_three(beg + 1, beg + 1 + step, beg + 1 + 2 * step, comp);
+         sort_three(mid - step, mid, mid + step, comp);
+         sort_three(last - 2 * step, last - step, last, comp);
+         sort_three(beg + 1 + step, mid, last - step, comp);
+      }
+      else
+      {
+         sort_three(beg + 1, mid, last, comp);
+      }
+
+      std::iter_swap(beg, mid);
+   }
+
+   /**
+    * Three-way partition around the pivot in `*beg`. Returns the range of the elements equivalent
+    * to the pivot, everything before it is smaller and everything after it is greater, so runs of
+    * duplicate keys are excluded from the recursion all at once.
+    */
+   template <typename It, typename Compare>
+   auto partition_three_way(It beg, It end, Compare comp) -> std::pair<It, It>
+   {
+      auto less_end = beg;
+      auto i = std::next(beg);
+      auto greater_begin = end;
+
+      // `*less_end` is always the pivot: it only ever swaps with a smaller element at `i`, which
+      // moves the pivot one step to the right.
+      while (i != greater_begin)
+      {
+         if (comp(*i, *less_end))
+         {
+            std::iter_swap(i, less_end);
+            ++less_end;
+            ++i;
+         }
+         else if (comp(*less_end, *i))
+         {
+            --greater_begin;
+            std::iter_swap(i, greater_begin);
+         }
+         else
+         {
+            ++i;
+         }
+      }
+
+      return {less_end, greater_begin};
+   }
+
+   template <typename It, typename Compare>
+   void introsort_loop(It beg, It end, int depth_limit, Compare comp)
+   {
+      while (std::distance(beg, end) > insertion_sort_cutoff)
+      {
+         if (depth_limit == 0)
+         {
+            heap_sort(beg, end, comp);
+            return;
+         }
+         --depth_limit;
+
+         select_pivot(beg, end, comp);
+         const auto [equal_begin, equal_end] = partition_three_way(beg, end, comp);
+
+         // Recursing into the smaller side only bounds the stack to log2(n) frames.
+         if (std::distance(beg, equal_begin) < std::distance(equal_end, end))
+         {
+            introsort_loop(beg, equal_begin, depth_limit, comp);
+            beg = equal_end;
+         }
+         else
+         {
+            introsort_loop(equal_end, end, depth_limit, comp);
+            end = equal_begin;
+         }
+      }
+
+      insertion_sort(beg, end, comp);
+   }
+} // namespace detail
+
+/**
+ * Sorts `[beg, end)` in place with an introsort: quicksort with median-of-three or ninther
+ * pivots and three-way partitioning, insertion sort on small ranges, and heapsort once the
+ * recursion gets deeper than 2 log2(n), which keeps the worst case at O(n log n). Not stable.
+ */
+template <std::random_access_iterator It, typename Compare = std::less<>>
+void introsort(It beg, It end, Compare comp = {})
+{
+   const auto size = static_cast<std::size_t>(std::distance(beg, end));
+   if (size < 2)
+   {
+      return;
+   }
+
+   const int depth_limit = 2 * (std::bit_width(size) - 1);
+   detail::introsort_loop(beg, end, depth_limit, comp);
+}
+
+#endif // LIBQSORT_INTROSORT_HPP_
@@ -0,0 +1,30 @@
+#ifndef LIBQSORT_LOCAL_SORT_HPP_
+#define LIBQSORT_LOCAL_SORT_HPP_
+
+#include <libqsort/integer_sort.hpp>
+#include <libqsort/parallel_introsort.hpp>
+
+#include <concepts>
+#include <functional>
+#include <iterator>
+
+/**
+ * Sorts `[beg, end)` by the keys `key` extracts, with the fastest kernel for the element type:
+ * integer_sort() for integers sorted by value, parallel_introsort() on `pool` for everything else.
+ */
+template <std::random_access_iterator It, typename Key = std::identity>
+void local_sort(work_stealing_pool& pool, It beg, It end, Key key = {})
+{
+   if constexpr (std::integral<std::iter_value_t<It>> and std::same_as<Key, std::identity>)
+   {
+      integer_sort(beg, end);
+   }
+   else
+   {
+      parallel_introsort(pool, beg, end, [key](const auto& lhs, const auto& rhs) {
+         return std::invoke(key, lhs) < std::invoke(key, rhs);
+      });
+   }
+}
+
+#endif // LIBQSORT_LOCAL_SORT_HPP_
@@ -0,0 +1,77 @@
+#ifndef LIBQSORT_PARALLEL_INTROSORT_HPP_
+#define LIBQSORT_PARALLEL_INTROSORT_HPP_
+
+#include <libqsort/introsort.hpp>
+#include <libqsort/work_stealing_pool.hpp>
+
+#include <bit>
+#include <functional>
+#include <iterator>
+
+/**
+ * Below this many elements a range is sorted sequentially rather than split into more tasks.
+ */
+inline constexpr std::ptrdiff_t parallel_sort_grain = 1 << 14;
+
+namespace detail
+{
+   template <typename It, typename Compare>
+   void parallel_introsort_task(work_stealing_pool& pool, It beg, It end, int depth_limit,
+                                Compare comp, std::ptrdiff_t grain)
+   {
+      while (std::distance(beg, end) > grain)
+      {
+         if (depth_limit == 0)
+         {
+            heap_sort(beg, end, comp);
+            return;
+         }
+         --depth_limit;
+
+         select_pivot(beg, end, comp);
+         const auto [equal_begin, equal_end] = partition_three_way(beg, end, comp);
+
+         // The smaller side becomes a task that idle threads may steal, the larger one stays.
+         if (std::distance(beg, equal_begin) < std::distance(equal_end, end))
+         {
+            pool.spawn([&pool, beg, equal_begin, depth_limit, comp, grain] {
+               parallel_introsort_task(pool, beg, equal_begin, depth_limit, comp, grain);
+            });
+            beg = equal_end;
+         }
+         else
+         {
+            pool.spawn([&pool, equal_end, end, depth_limit, comp, grain] {
+               parallel_introsort_task(pool, equal_end, end, depth_limit, comp, grain);
+            });
+            end = equal_begin;
+         }
+      }
+
+      introsort_loop(beg, end, depth_limit, comp);
+   }
+} // namespace detail
+
+/**
+ * Sorts `[beg, end)` in place on the threads of `pool` with the introsort of introsort(), every
+ * partitioning step handing one side to the pool as a task. Ranges of at most `grain` elements,
+ * and the whole range on a single thread pool, are sorted sequentially. Not stable.
+ */
+template <std::random_access_iterator It, typename Compare = std::less<>>
+void parallel_introsort(work_stealing_pool& pool, It beg, It end, Compare comp = {},
+                        std::ptrdiff_t grain = parallel_sort_grain)
+{
+   const auto size = static_cast<std::size_t>(std::distance(beg, end));
+   if (pool.size() == 1 or size <= static_cast<std::size_t>(grain))
+   {
+      introsort(beg, end, comp);
+      return;
+   }
+
+   const int depth_limit = 2 * (std::bit_width(size) - 1);
+   pool.run([&pool, beg, end, depth_limit, comp, grain] {
+      detail::parallel_introsort_task(pool, beg, end, depth_limit, comp, grain);
+   });
+}
+
+#endif // LIBQSORT_PARALLEL_INTROSORT_HPP_
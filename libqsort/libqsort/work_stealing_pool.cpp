@@ -0,0 +1,165 @@
+#include <libqsort/work_stealing_pool.hpp>
+
+#include <algorithm>
+
+namespace
+{
+   // The pool and member index of the calling thread, so spawn() knows which deque to push on.
+   thread_local const work_stealing_pool* current_pool = nullptr;
+   thread_local u32 current_member = 0;
+} // namespace
+
+work_stealing_pool::work_stealing_pool(u32 thread_count) :
+   m_size(std::max(thread_count, 1U)), m_queues(m_size)
+{
+   m_threads.reserve(m_size - 1);
+   for (u32 member = 1; member < m_size; ++member)
+   {
+      m_threads.emplace_back([this, member] {
+         current_pool = this;
+         current_member = member;
+
+         work(member);
+      });
+   }
+}
+
+work_stealing_pool::~work_stealing_pool()
+{
+   m_stopping.store(true, std::memory_order_release);
+
+   // Wakes the idle threads, which see `m_stopping` once they find nothing to run.
+   m_queued.fetch_add(1, std::memory_order_release);
+   m_queued.notify_all();
+
+   for (auto& thread : m_threads)
+   {
+      thread.join();
+   }
+}
+
+void work_stealing_pool::run(task root)
+{
+   const auto* const outer_pool = std::exchange(current_pool, this);
+   const u32 outer_member = std::exchange(current_member, 0);
+
+   spawn(std::move(root));
+
+   while (true)
+   {
+      const u64 pending = m_pending.load(std::memory_order_acquire);
+      if (pending == 0)
+      {
+         break;
+      }
+
+      // Every spawn and every completion changes `m_pending`, so the wait ends as soon as there
+      // is a task to help with or the last one is done.
+      if (not run_one(0))
+      {
+         m_pending.wait(pending, std::memory_order_acquire);
+      }
+   }
+
+   current_pool = outer_pool;
+   current_member = outer_member;
+}
+
+void work_stealing_pool::spawn(task work)
+{
+   const u32 member = current_pool == this ? current_member : 0;
+
+   m_pending.fetch_add(1, std::memory_order_relaxed);
+   // Counted before it is pushed, so `m_queued` never drops below the tasks in the deques.
+   m_queued.fetch_add(1, std::memory_order_relaxed);
+
+   {
+      const std::lock_guard lock(m_queues[member].mutex);
+      m_queues[member].tasks.push_back(std::move(work));
+   }
+
+   m_queued.notify_one();
+   m_pending.notify_all();
+}
+
+auto work_stealing_pool::size() const noexcept -> u32
+{
+   return m_size;
+}
+
+auto work_stealing_pool::pop_local(u32 member) -> task
+{
+   auto& queue = m_queues[member];
+
+   const std::lock_guard lock(queue.mutex);
+   if (queue.tasks.empty())
+   {
+      return {};
+   }
+
+   auto work = std::move(queue.tasks.back());
+   queue.tasks.pop_back();
+   m_queued.fetch_sub(1, std::memory_order_relaxed);
+
+   return work;
+}
+
+auto work_stealing_pool::steal(u32 thief) -> task
+{
+   for (u32 offset = 1; offset < m_size; ++offset)
+   {
+      auto& queue = m_queues[(thief + offset) % m_size];
+
+      const std::lock_guard lock(queue.mutex);
+      if (not queue.tasks.empty())
+      {
+         auto work = std::move(queue.tasks.front());
+         queue.tasks.pop_front();
+         m_queued.fetch_sub(1, std::memory_order_relaxed);
+
+         return work;
+      }
+   }
+
+   return {};
+}
+
+auto work_stealing_pool::run_one(u32 member) -> bool
+{
+   auto work = pop_local(member);
+   if (not work)
+   {
+      work = steal(member);
+   }
+
+   if (not work)
+   {
+      return false;
+   }
+
+   work();
+   m_pending.fetch_sub(1, std::memory_order_release);
+   m_pending.notify_all();
+
+   return true;
+}
+
+void work_stealing_pool::work(u32 member)
+{
+   while (true)
+   {
+      if (run_one(member))
+      {
+         continue;
+      }
+
+      if (m_stopping.load(std::memory_order_acquire))
+      {
+         return;
+      }
+
+      // A task counted in `m_queued` may be in the middle of being pushed or popped, in which
+      // case the wait returns at once and the deques are looked at again.
+      m_queued.wait(0, std::memory_order_acquire);
+   }
+}
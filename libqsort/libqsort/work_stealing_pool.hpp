@@ -0,0 +1,82 @@
+#ifndef LIBQSORT_WORK_STEALING_POOL_HPP_
+#define LIBQSORT_WORK_STEALING_POOL_HPP_
+
+#include <libqsort/types.hpp>
+
+#include <libcpu-affinity/cpu_affinity.hpp>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * A fixed set of threads running fork-join task graphs. Every thread owns a deque of tasks: it
+ * pushes and pops its own tasks at the back, so it keeps working on the most recent and smallest
+ * ones while they are still in cache, and when it runs dry it steals from the front of another
+ * deque, where the oldest and largest tasks are.
+ *
+ * The thread calling run() takes part as the first member of the pool. Threads that find no task
+ * to run sleep on an atomic wait until one is spawned, so an idle pool leaves its cores to the
+ * other threads and ranks.
+ */
+class work_stealing_pool
+{
+public:
+   using task = std::function<void()>;
+
+   explicit work_stealing_pool(u32 thread_count);
+   work_stealing_pool(const work_stealing_pool&) = delete;
+   work_stealing_pool(work_stealing_pool&&) = delete;
+   ~work_stealing_pool();
+
+   auto operator=(const work_stealing_pool&) -> work_stealing_pool& = delete;
+   auto operator=(work_stealing_pool&&) -> work_stealing_pool& = delete;
+
+   /**
+    * Runs `root` and every task it spawns, directly or not, and returns once all of them are
+    * done. Not reentrant.
+    */
+   void run(task root);
+
+   /**
+    * Queues `work` on the deque of the calling thread. Only valid from a task of this pool.
+    */
+   void spawn(task work);
+
+   [[nodiscard]] auto size() const noexcept -> u32;
+
+private:
+   static constexpr std::size_t cache_line_size = 64;
+
+   struct alignas(cache_line_size) task_queue
+   {
+      std::mutex mutex;
+      std::deque<task> tasks;
+   };
+
+   auto pop_local(u32 member) -> task;
+   auto steal(u32 thief) -> task;
+
+   // Runs one task if any is available, returns false otherwise.
+   auto run_one(u32 member) -> bool;
+   void work(u32 member);
+
+private:
+   u32 m_size;
+
+   std::vector<task_queue> m_queues;
+
+   // Tasks spawned and not yet done, which run() waits on.
+   std::atomic<u64> m_pending = 0;
+   // Tasks sitting in a deque, which idle threads sleep on until one shows up.
+   std::atomic<u64> m_queued = 0;
+   std::atomic<bool> m_stopping = false;
+
+   std::vector<std::thread> m_threads;
+};
+
+#endif // LIBQSORT_WORK_STEALING_POOL_HPP_
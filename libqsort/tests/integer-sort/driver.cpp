@@ -0,0 +1,132 @@
+#include <libqsort/integer_sort.hpp>
+#include <libqsort/types.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+   template <typename T>
+   auto uniform_keys(std::size_t size, T min, T max, u64 seed) -> std::vector<T>
+   {
+      auto random_engine = std::mt19937_64(seed);
+      auto key = std::uniform_int_distribution<T>(min, max);
+
+      auto keys = std::vector<T>(size);
+      for (T& value : keys)
+      {
+         value = key(random_engine);
+      }
+
+      return keys;
+   }
+
+   // integer_sort(), and the counting and radix sorts it picks from whatever the key range, against
+   // std::sort.
+   template <typename T>
+   auto check(std::string_view name, const std::vector<T>& keys) -> bool
+   {
+      auto expected = keys;
+      std::sort(expected.begin(), expected.end());
+
+      auto sorted = keys;
+      integer_sort(sorted.begin(), sorted.end());
+
+      bool passed = sorted == expected;
+      if (not keys.empty())
+      {
+         const auto [min, max] = std::minmax_element(keys.begin(), keys.end());
+         const auto span = detail::key_offset<T>(*max, *min);
+
+         auto radix_sorted = keys;
+         detail::lsd_radix_sort(radix_sorted.begin(), radix_sorted.end(), *min, span);
+         passed = passed and radix_sorted == expected;
+
+         // Only small spans get a count array.
+         if (span <= (1U << 20))
+         {
+            auto counted = keys;
+            detail::counting_sort(counted.begin(), counted.end(), *min, span);
+            passed = passed and counted == expected;
+         }
+      }
+
+      if (not passed)
+      {
+         std::cerr << "integer_sort misorders " << keys.size() << " " << name << " keys\n";
+      }
+
+      return passed;
+   }
+
+   template <typename T>
+   auto check_type(std::string_view type_name) -> bool
+   {
+      using limits = std::numeric_limits<T>;
+
+      const auto name = [&](std::string_view keys) {
+         return std::string(type_name) + " " + std::string(keys);
+      };
+
+      bool passed = check<T>(name("empty"), {});
+      passed = check<T>(name("single"), {limits::min()}) and passed;
+      passed = check<T>(name("single"), {limits::max()}) and passed;
+
+      for (const std::size_t size : {2, 24, 25, 1000, 100'000})
+      {
+         const auto span = static_cast<T>(size);
+
+         passed = check(name("negative"), uniform_keys<T>(size, -span, -1, size)) and passed;
+         passed = check(name("signed"), uniform_keys<T>(size, -span, span, size)) and passed;
+
+         // The offsets from the smallest key span the whole type.
+         auto extremes = uniform_keys<T>(size, limits::min(), limits::max(), size);
+         extremes.front() = limits::min();
+         extremes.back() = limits::max();
+         passed = check(name("min and max"), extremes) and passed;
+
+         // Spans of one less than the size are counted, spans of the size are radix sorted.
+         for (const T width : {static_cast<T>(span - 1), span})
+         {
+            auto keys = uniform_keys<T>(size, -7, static_cast<T>(width - 7), size);
+            keys.front() = -7;
+            keys.back() = static_cast<T>(width - 7);
+            passed = check(name("boundary span"), keys) and passed;
+         }
+      }
+
+      return passed;
+   }
+
+   // 64-bit keys differing in their low bytes only, the high digits of which radix sort skips.
+   auto check_shared_high_bytes() -> bool
+   {
+      bool passed = true;
+      for (const i64 high : {i64{0x1234'5678'0000'0000}, -i64{0x1234'5678'0000'0000}})
+      {
+         for (const std::size_t size : {30, 1000, 100'000})
+         {
+            auto keys = uniform_keys<i64>(size, high, high + 0xff'ffff, size);
+            passed = check("i64 shared high bytes", keys) and passed;
+         }
+      }
+
+      return passed;
+   }
+} // namespace
+
+auto main() -> int
+{
+   bool passed = check_type<i32>("i32");
+   passed = check_type<i64>("i64") and passed;
+   passed = check_shared_high_bytes() and passed;
+
+   return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
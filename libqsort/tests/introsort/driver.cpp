@@ -0,0 +1,165 @@
+#include <libqsort/introsort.hpp>
+#include <libqsort/parallel_introsort.hpp>
+#include <libqsort/types.hpp>
+#include <libqsort/work_stealing_pool.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+   struct input
+   {
+      std::string_view name;
+      std::vector<i32> values;
+   };
+
+   // The inputs quicksorts trip on, of `size` elements each.
+   auto make_inputs(std::size_t size) -> std::vector<input>
+   {
+      auto random_engine = std::mt19937_64(size);
+      auto value = std::uniform_int_distribution<i32>(-1'000'000, 1'000'000);
+
+      auto inputs = std::vector<input>{{"uniform", std::vector<i32>(size)},
+                                       {"sorted", std::vector<i32>(size)},
+                                       {"reverse", std::vector<i32>(size)},
+                                       {"organ-pipe", std::vector<i32>(size)},
+                                       {"all-equal", std::vector<i32>(size, 7)},
+                                       {"few-unique", std::vector<i32>(size)}};
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         inputs[0].values[i] = value(random_engine);
+         inputs[1].values[i] = static_cast<i32>(i);
+         inputs[2].values[i] = static_cast<i32>(size - i);
+         inputs[3].values[i] = static_cast<i32>(std::min(i, size - 1 - i));
+         inputs[5].values[i] = value(random_engine) % 4;
+      }
+
+      return inputs;
+   }
+
+   /**
+    * McIlroy's adversary ("A Killer Adversary for Quicksort"): sorts indices while deciding the
+    * values they compare as late as possible, always against the current pivot candidate, and
+    * returns the values it settled on. Sorted again, they drive the same quicksort to quadratic
+    * partitioning, which introsort() must cut short with its heapsort fallback.
+    */
+   auto median_of_3_killer(std::size_t size) -> std::vector<i32>
+   {
+      const auto gas = static_cast<i32>(size);
+
+      auto values = std::vector<i32>(size, gas);
+      auto indices = std::vector<i32>(size);
+      for (std::size_t i = 0; i < size; ++i)
+      {
+         indices[i] = static_cast<i32>(i);
+      }
+
+      i32 solid_count = 0;
+      i32 candidate = 0;
+      introsort(indices.begin(), indices.end(), [&](i32 lhs, i32 rhs) {
+         if (values[lhs] == gas and values[rhs] == gas)
+         {
+            values[lhs == candidate ? lhs : rhs] = solid_count++;
+         }
+
+         if (values[lhs] == gas)
+         {
+            candidate = lhs;
+         }
+         else if (values[rhs] == gas)
+         {
+            candidate = rhs;
+         }
+
+         return values[lhs] < values[rhs];
+      });
+
+      return values;
+   }
+
+   // `sort` against std::sort on every input and the sizes around the cutoffs of introsort.
+   template <typename Sort>
+   auto check_inputs(std::string_view sort_name, Sort sort) -> bool
+   {
+      constexpr std::ptrdiff_t cutoff = detail::insertion_sort_cutoff;
+      constexpr std::ptrdiff_t ninther = detail::ninther_threshold;
+
+      bool passed = true;
+      for (const std::ptrdiff_t size :
+           {std::ptrdiff_t{0}, std::ptrdiff_t{1}, std::ptrdiff_t{2}, cutoff - 1, cutoff, cutoff + 1,
+            ninther - 1, ninther, ninther + 1, std::ptrdiff_t{1000}, std::ptrdiff_t{100'003}})
+      {
+         for (auto& [name, values] : make_inputs(static_cast<std::size_t>(size)))
+         {
+            auto expected = values;
+            std::sort(expected.begin(), expected.end());
+
+            sort(values);
+            if (values != expected)
+            {
+               std::cerr << sort_name << " misorders " << size << " " << name << " elements\n";
+               passed = false;
+            }
+         }
+      }
+
+      return passed;
+   }
+
+   // The adversarial input stays within the O(n log n) comparisons of the heapsort fallback.
+   auto check_killer() -> bool
+   {
+      constexpr std::size_t size = 1 << 14;
+
+      auto values = median_of_3_killer(size);
+      auto expected = values;
+      std::sort(expected.begin(), expected.end());
+
+      u64 comparison_count = 0;
+      introsort(values.begin(), values.end(), [&](i32 lhs, i32 rhs) {
+         ++comparison_count;
+         return lhs < rhs;
+      });
+
+      const u64 bound = 8 * size * static_cast<u64>(std::bit_width(size));
+      if (values != expected or comparison_count > bound)
+      {
+         std::cerr << "introsort took " << comparison_count << " comparisons (at most " << bound
+                   << ") on the adversarial input\n";
+         return false;
+      }
+
+      return true;
+   }
+} // namespace
+
+auto main() -> int
+{
+   bool passed = check_inputs("introsort", [](std::vector<i32>& values) {
+      introsort(values.begin(), values.end());
+   });
+   passed = check_killer() and passed;
+
+   for (const u32 thread_count : {1U, 3U, 2 * available_cpu_count()})
+   {
+      auto pool = work_stealing_pool(thread_count);
+
+      // The default grain keeps all but the largest inputs sequential, a small one splits them
+      // into many tasks.
+      passed = check_inputs("parallel_introsort", [&](std::vector<i32>& values) {
+         parallel_introsort(pool, values.begin(), values.end());
+      }) and passed;
+      passed = check_inputs("parallel_introsort with a grain of 32", [&](std::vector<i32>& values) {
+         parallel_introsort(pool, values.begin(), values.end(), std::less<>{}, 32);
+      }) and passed;
+   }
+
+   return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
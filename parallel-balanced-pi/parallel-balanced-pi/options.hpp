@@ -0,0 +1,34 @@
+#ifndef PARALLEL_BALANCED_PI_OPTIONS_HPP_
+#define PARALLEL_BALANCED_PI_OPTIONS_HPP_
+
+#include <parallel-balanced-pi/types.hpp>
+
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+
+// Samples drawn in one batch, batch b of a seed always draws the same samples.
+inline constexpr u64 sample_count = 10000;
+
+// Upper bound of options::chunk_size, which sizes the result messages sent to the master.
+inline constexpr u64 max_chunk_size = 256;
+
+enum class sampler
+{
+   pseudo_random, // Philox streams, one per batch
+   sobol          // contiguous slices of a scrambled Sobol sequence, one per batch
+};
+
+struct options
+{
+   std::optional<u64> seed;
+   sampler sampling = sampler::pseudo_random;
+   u64 strata = 1; // the unit square is split into strata x strata cells
+   f64 tolerance = 1e-4; // half-width of the 95% confidence interval to stop at
+   u64 chunk_size = 4; // batches handed to a worker per request
+};
+
+auto parse_options(std::span<char*> args) -> std::expected<options, std::string>;
+
+#endif // PARALLEL_BALANCED_PI_OPTIONS_HPP_
@@ -1,14 +1,293 @@
+#include <parallel-balanced-pi/options.hpp>
+#include <parallel-balanced-pi/types.hpp>
+
+#include <libmonte-carlo/circle_hits.hpp>
+#include <libmonte-carlo/monte_carlo.hpp>
+#include <libmonte-carlo/philox.hpp>
+#include <libmonte-carlo/running_statistics.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <iostream>
+#include <random>
+#include <vector>
+
+#include <mpi.h>
+
+// Rank 0 is the master: it hands out chunks of batches on request, folds the per-batch hits that
+// come back and decides convergence on its own. Workers never synchronize with each other, so a
+// slow rank only delays the chunk it holds and faster ranks simply come back for more.
+//
+// Batch b always draws the same samples for a given seed, and convergence is tested on the
+// longest run of completed batches starting at 0, so the result does not depend on the number
+// or the speed of the ranks.
+
+static constexpr int assignment_tag = 0;
+static constexpr int result_tag = 1;
+
+// An assignment is {first_batch, batch_count}, a batch_count of 0 tells the worker to stop. A
+// result is {first_batch, batch_count, bit pattern of the estimate of each batch...}.
+static constexpr u64 result_header_size = 2;
+
+// Estimates of every batch completed so far, folded into running statistics as soon as they
+// extend the prefix of completed batches.
+class batch_ledger
+{
+public:
+   explicit batch_ledger(f64 tolerance = 0.0) : m_tolerance(tolerance) {}
+
+   void record(u64 batch, f64 value)
+   {
+      if (batch >= m_values.size())
+      {
+         m_values.resize(batch + 1, 0.0);
+         m_done.resize(batch + 1, false);
+      }
+
+      m_values[batch] = value;
+      m_done[batch] = true;
+
+      while (not m_converged and m_prefix.count < m_done.size() and m_done[m_prefix.count])
+      {
+         m_prefix.add(m_values[m_prefix.count]);
+
+         m_converged = is_converging(m_prefix, m_tolerance);
+      }
+   }
+
+   [[nodiscard]] auto estimate() const -> const running_statistics& { return m_prefix; }
+   [[nodiscard]] auto converged() const -> bool { return m_converged; }
+   [[nodiscard]] auto batch_count() const -> u64 { return m_prefix.count; }
+
+private:
+   std::vector<f64> m_values;
+   std::vector<bool> m_done;
+
+   f64 m_tolerance;
+   running_statistics m_prefix;
+   bool m_converged = false;
+};
+
+template <typename Estimator>
+auto run_master(const Estimator& estimator, const options& opts, int process_count)
+   -> batch_ledger;
+template <typename Estimator>
+auto run_worker(const Estimator& estimator) -> void;
 
-int main (int argc, char* argv[])
+auto main(int argc, char* argv[]) -> int
 {
-  using namespace std;
+   int process_id = 0;
+   int process_count = 0;
+
+   MPI_Init(&argc, &argv);
+
+   const f64 start_time = MPI_Wtime();
+
+   MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+   MPI_Comm_rank(MPI_COMM_WORLD, &process_id);
+
+   const auto opts = parse_options({argv, static_cast<std::size_t>(argc)});
+   if (not opts)
+   {
+      if (process_id == 0)
+      {
+         std::cout << "error: " << opts.error() << '\n';
+      }
+
+      MPI_Finalize();
+
+      return EXIT_FAILURE;
+   }
+
+   u64 seed = 0;
+   if (process_id == 0)
+   {
+      std::random_device rd;
+      seed = opts->seed.value_or((static_cast<u64>(rd()) << 32) | rd());
+   }
+
+   MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+   batch_ledger ledger;
+   const auto run = [&](auto sampler) {
+      const auto estimator =
+         monte_carlo::estimator<2, monte_carlo::circle_indicator, decltype(sampler),
+                                monte_carlo::stratified_box<2>>(
+            {}, sampler, monte_carlo::stratified_box<2>({0.0, 0.0}, {1.0, 1.0}, opts->strata),
+            sample_count);
+
+      if (process_id == 0)
+      {
+         ledger = run_master(estimator, *opts, process_count);
+      }
+      else
+      {
+         run_worker(estimator);
+      }
+   };
+
+   if (opts->sampling == sampler::sobol)
+   {
+      run(monte_carlo::sobol_sampler(seed, sample_count));
+   }
+   else
+   {
+      run(monte_carlo::philox_sampler<2>(seed, sample_count));
+   }
+
+   const f64 elapsed_time = MPI_Wtime() - start_time;
+
+   MPI_Finalize();
+
+   if (process_id == 0)
+   {
+      std::cout << "seed: " << seed << '\n';
+      std::cout << "sampler: " << (opts->sampling == sampler::sobol ? "sobol" : "philox") << '\n';
+      std::cout << "strata: " << opts->strata << 'x' << opts->strata << '\n';
+      std::cout << "simd kernel: " << circle_hits_kernel_name() << " (rng: "
+                << philox_kernel_name() << ")\n";
+      std::cout << "iteration to converge: " << ledger.batch_count() << '\n';
+      std::cout << "total samples: " << ledger.batch_count() * sample_count << '\n';
+      std::cout << "result: " << ledger.estimate().mean << " +/- "
+                << ledger.estimate().half_width() << '\n';
+      std::cout << "elapsed time: " << elapsed_time << '\n';
+   }
+
+   return EXIT_SUCCESS;
+}
+
+template <typename Estimator>
+auto run_master(const Estimator& estimator, const options& opts, int process_count)
+   -> batch_ledger
+{
+   const u64 chunk_size = opts.chunk_size;
+
+   auto ledger = batch_ledger(opts.tolerance);
+   u64 next_batch = 0;
+
+   // Work assignments sent to each worker and not yet answered by a result.
+   auto in_flight = std::vector<u64>(process_count, 0);
+   auto batches_done = std::vector<u64>(process_count, 0);
+
+   const auto assign = [&](int worker) {
+      std::array<u64, 2> assignment = {next_batch, ledger.converged() ? 0 : chunk_size};
+
+      if (assignment[1] != 0)
+      {
+         next_batch += chunk_size;
+         ++in_flight[worker];
+      }
+
+      MPI_Send(assignment.data(), 2, MPI_UINT64_T, worker, assignment_tag, MPI_COMM_WORLD);
+   };
+
+   // Two chunks per worker, so the next one is already queued when the current one finishes.
+   for (int worker = 1; worker < process_count; ++worker)
+   {
+      assign(worker);
+      assign(worker);
+   }
+
+   auto result = std::vector<u64>(result_header_size + max_chunk_size);
+   const auto receive_result = [&](const MPI_Status& probed) {
+      MPI_Recv(result.data(), static_cast<int>(result.size()), MPI_UINT64_T, probed.MPI_SOURCE,
+               result_tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+      const u64 first_batch = result[0];
+      const u64 batch_count = result[1];
+      for (u64 i = 0; i < batch_count; ++i)
+      {
+         ledger.record(first_batch + i, std::bit_cast<f64>(result[result_header_size + i]));
+      }
+
+      batches_done[probed.MPI_SOURCE] += batch_count;
+      --in_flight[probed.MPI_SOURCE];
+
+      assign(probed.MPI_SOURCE);
+   };
+
+   const auto has_work_in_flight = [&] {
+      return std::any_of(begin(in_flight), end(in_flight), [](u64 n) { return n != 0; });
+   };
+
+   while (not ledger.converged() or has_work_in_flight())
+   {
+      MPI_Status status;
+
+      if (ledger.converged())
+      {
+         // Nothing left to sample, only wait for the outstanding chunks.
+         MPI_Probe(MPI_ANY_SOURCE, result_tag, MPI_COMM_WORLD, &status);
+         receive_result(status);
+
+         continue;
+      }
+
+      int pending = 0;
+      MPI_Iprobe(MPI_ANY_SOURCE, result_tag, MPI_COMM_WORLD, &pending, &status);
+      while (pending != 0)
+      {
+         receive_result(status);
+         MPI_Iprobe(MPI_ANY_SOURCE, result_tag, MPI_COMM_WORLD, &pending, &status);
+      }
+
+      // The master samples one batch at a time in between so it stays responsive.
+      if (not ledger.converged())
+      {
+         const u64 batch = next_batch++;
+
+         ledger.record(batch, estimator.batch_value(batch));
+         ++batches_done[0];
+      }
+   }
+
+   for (int rank = 0; rank < process_count; ++rank)
+   {
+      std::cout << "P" << rank << " - " << batches_done[rank] << " batches sampled\n";
+   }
+
+   return ledger;
+}
+
+template <typename Estimator>
+auto run_worker(const Estimator& estimator) -> void
+{
+   auto result = std::vector<u64>(result_header_size + max_chunk_size);
+
+   // Replies the master still owes this worker; it sent two up front and answers every result.
+   u64 pending_replies = 2;
+   bool stopped = false;
+
+   while (pending_replies != 0)
+   {
+      std::array<u64, 2> assignment{};
+      MPI_Recv(assignment.data(), 2, MPI_UINT64_T, 0, assignment_tag, MPI_COMM_WORLD,
+               MPI_STATUS_IGNORE);
+      --pending_replies;
+
+      const u64 first_batch = assignment[0];
+      const u64 batch_count = assignment[1];
+      if (batch_count == 0)
+      {
+         stopped = true;
+
+         continue;
+      }
+
+      // Chunks still queued after a stop are handed back unsampled, the master has converged.
+      const u64 sampled_count = stopped ? 0 : batch_count;
 
-  if (argc < 2)
-  {
-    cerr << "error: missing name" << endl;
-    return 1;
-  }
+      result[0] = first_batch;
+      result[1] = sampled_count;
+      for (u64 i = 0; i < sampled_count; ++i)
+      {
+         const f64 value = estimator.batch_value(first_batch + i);
+         result[result_header_size + i] = std::bit_cast<u64>(value);
+      }
 
-  cout << "Hello, " << argv[1] << '!' << endl;
+      MPI_Send(result.data(), static_cast<int>(result_header_size + sampled_count), MPI_UINT64_T,
+               0, result_tag, MPI_COMM_WORLD);
+      ++pending_replies;
+   }
 }
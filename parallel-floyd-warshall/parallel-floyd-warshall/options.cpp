@@ -0,0 +1,101 @@
+#include <parallel-floyd-warshall/options.hpp>
+
+#include <charconv>
+#include <string_view>
+
+namespace
+{
+   template <typename T>
+   auto parse_number(std::string_view name, std::string_view text) -> std::expected<T, std::string>
+   {
+      T value{};
+      const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+      if (error != std::errc() or end != text.data() + text.size())
+      {
+         return std::unexpected("invalid value '" + std::string(text) + "' for " +
+                                std::string(name));
+      }
+
+      return value;
+   }
+
+   // Parses the value following the option at `args[i]` and moves `i` past it.
+   template <typename T>
+   auto next_number(std::span<char*> args, std::size_t& i) -> std::expected<T, std::string>
+   {
+      const std::string_view name = args[i];
+      if (i + 1 >= args.size())
+      {
+         return std::unexpected("missing value for " + std::string(name));
+      }
+
+      return parse_number<T>(name, args[++i]);
+   }
+} // namespace
+
+// `--vertices N`, `--edges-per-vertex N`, `--seed N`, `--threads N` and `--pipelined`.
+auto parse_options(std::span<char*> args) -> std::expected<options, std::string>
+{
+   options result;
+
+   for (std::size_t i = 1; i < args.size(); ++i)
+   {
+      const std::string_view arg = args[i];
+
+      if (arg == "--pipelined")
+      {
+         result.pipelined = true;
+      }
+      else if (arg == "--vertices")
+      {
+         const auto vertex_count = next_number<u32>(args, i);
+         if (not vertex_count)
+         {
+            return std::unexpected(vertex_count.error());
+         }
+         if (*vertex_count == 0 or *vertex_count > max_vertex_count)
+         {
+            return std::unexpected("--vertices must be between 1 and " +
+                                   std::to_string(max_vertex_count));
+         }
+
+         result.vertex_count = *vertex_count;
+      }
+      else if (arg == "--edges-per-vertex")
+      {
+         const auto edges_per_vertex = next_number<u32>(args, i);
+         if (not edges_per_vertex)
+         {
+            return std::unexpected(edges_per_vertex.error());
+         }
+
+         result.edges_per_vertex = *edges_per_vertex;
+      }
+      else if (arg == "--seed")
+      {
+         const auto seed = next_number<u64>(args, i);
+         if (not seed)
+         {
+            return std::unexpected(seed.error());
+         }
+
+         result.seed = *seed;
+      }
+      else if (arg == "--threads")
+      {
+         const auto thread_count = next_number<u32>(args, i);
+         if (not thread_count)
+         {
+            return std::unexpected(thread_count.error());
+         }
+
+         result.thread_count = *thread_count;
+      }
+      else
+      {
+         return std::unexpected("unknown option " + std::string(arg));
+      }
+   }
+
+   return result;
+}
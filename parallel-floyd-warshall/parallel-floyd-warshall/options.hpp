@@ -0,0 +1,33 @@
+#ifndef PARALLEL_FLOYD_WARSHALL_OPTIONS_HPP_
+#define PARALLEL_FLOYD_WARSHALL_OPTIONS_HPP_
+
+#include <parallel-floyd-warshall/types.hpp>
+
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+
+// Most vertices of a random graph. Its matrix is scattered with i32 counts, and padding this
+// multiple of 128 to a grid of up to 128 x 128 processes keeps it under 2^31 distances.
+inline constexpr u32 max_vertex_count = 46'336;
+
+struct options
+{
+   // Solves a random graph of this many vertices instead of the sample matrix, timing the solve
+   // rather than printing every iteration.
+   std::optional<u32> vertex_count;
+
+   u32 edges_per_vertex = 8;
+   u64 seed = 1;
+
+   // Threads of every process, 0 starts one per available CPU.
+   u32 thread_count = 1;
+
+   // Sends the (k + 1)-th column and row while iteration k is computed.
+   bool pipelined = false;
+};
+
+auto parse_options(std::span<char*> args) -> std::expected<options, std::string>;
+
+#endif // PARALLEL_FLOYD_WARSHALL_OPTIONS_HPP_
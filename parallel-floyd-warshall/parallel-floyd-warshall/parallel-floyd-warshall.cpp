@@ -1,23 +1,28 @@
+#include <parallel-floyd-warshall/options.hpp>
+#include <parallel-floyd-warshall/types.hpp>
+
+#include <libfloyd-warshall/distance.hpp>
+#include <libfloyd-warshall/min_plus.hpp>
+#include <libfloyd-warshall/random_graph.hpp>
+#include <libfloyd-warshall/thread_team.hpp>
+
 #include <algorithm>
+#include <array>
 #include <cmath>
-#include <cstdint>
 #include <fstream>
 #include <iostream>
-#include <limits>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include <mpi.h>
 
-using i32 = std::int32_t;
-using i64 = std::int64_t;
-
-using u32 = std::uint32_t;
-using u64 = std::uint64_t;
-
-using f32 = float;
-using f64 = double;
-
-static constexpr i32 mark = std::numeric_limits<i32>::max();
+// The tombstone, short enough to keep the sample matrix readable. Its weights are far within
+// max_edge_weight().
+static constexpr i32 mark = tombstone;
 
 static const auto matrix = std::vector<i32>(
    {0,    1,    mark, mark, 4,    mark, mark, mark, mark, mark, mark, mark, mark, mark, mark, mark,
@@ -102,30 +107,108 @@ static const auto matrix = std::vector<i32>(
     mark, mark, mark, mark, mark, mark, mark, mark, mark, mark, mark, mark, mark, mark, mark, mark,
     mark, mark, mark, mark, mark, mark, mark, mark, mark, mark, mark, mark, mark, mark, 1,    0});
 
+auto create_random_matrix(u32 vertex_count, u32 edges_per_vertex, u64 seed, u32 padding)
+   -> std::vector<i32>;
 auto interlace_matrix(const std::vector<i32>& m, i32 div_count) -> std::vector<i32>;
 auto deinterlace_matrix(const std::vector<i32>& m, i32 div_count) -> std::vector<i32>;
 
 template <typename It>
 auto format_range(It begin, It end) -> std::string;
-auto format_matrix(const std::vector<i32>& matrix) -> std::string;
+auto format_matrix(std::span<const i32> matrix) -> std::string;
 
 auto is_power_of_2(i32 n) -> bool;
+auto is_perfect_square(i32 n) -> bool;
+
+// The k-th column of a local matrix, in place or copied out.
+struct strided_view
+{
+   const i32* data;
+   i32 stride;
+
+   auto operator[](i32 i) const -> i32
+   {
+      return data[i * stride];
+   }
+};
+
+auto member_rows(u32 member, u32 member_count, i32 row_count) -> std::pair<i32, i32>;
 
 auto main(int argc, char** argv) -> int
 {
    int process_id = 0;
    int process_count = 0;
 
-   MPI_Init(&argc, &argv);
+   // Only the main thread, member 0 of the team, talks to MPI.
+   int thread_support = 0;
+   MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &thread_support);
 
    const f64 start_time = MPI_Wtime();
 
    MPI_Comm_size(MPI_COMM_WORLD, &process_count);
    MPI_Comm_rank(MPI_COMM_WORLD, &process_id);
 
-   if (not is_power_of_2(process_count))
+   const auto opts = parse_options({argv, static_cast<std::size_t>(argc)});
+   if (not opts)
    {
-      std::cout << "Process count (" << process_count << ") is not a power of 2\n";
+      if (process_id == 0)
+      {
+         std::cout << "error: " << opts.error() << '\n';
+      }
+
+      MPI_Finalize();
+
+      return EXIT_FAILURE;
+   }
+
+   // A team of more than one thread needs MPI to accept calls from its main thread while the
+   // others run.
+   const u32 thread_count = opts->thread_count == 0 ? available_cpu_count() : opts->thread_count;
+   if (thread_count > 1 and thread_support < MPI_THREAD_FUNNELED)
+   {
+      if (process_id == 0)
+      {
+         std::cout << "error: " << thread_count
+                   << " threads per process need MPI_THREAD_FUNNELED, which this MPI does not "
+                      "provide; run with --threads 1\n";
+      }
+
+      MPI_Finalize();
+
+      return EXIT_FAILURE;
+   }
+
+   // The matrix is split over a square grid of processes.
+   if (not is_power_of_2(process_count) or not is_perfect_square(process_count))
+   {
+      if (process_id == 0)
+      {
+         std::cout << "error: the process count (" << process_count
+                   << ") must be a power of 4, such as 1, 4 or 16\n";
+      }
+
+      MPI_Finalize();
+
+      return EXIT_FAILURE;
+   }
+
+   // The sample matrix is small enough to follow iteration by iteration. Random graphs are timed
+   // instead, with nothing printed between the start and the end of the solve.
+   const bool trace = not opts->vertex_count;
+
+   // A random graph is padded with isolated vertices to split evenly over the process grid, the
+   // sample matrix has to split as it is.
+   const auto process_row_count = static_cast<u32>(std::sqrt(process_count));
+   const auto sample_width = static_cast<u32>(std::sqrt(matrix.size()));
+   if (trace and sample_width % process_row_count != 0)
+   {
+      if (process_id == 0)
+      {
+         std::cout << "error: the sample matrix of " << sample_width
+                   << " vertices does not split over " << process_count
+                   << " processes, solve a random graph with --vertices instead\n";
+      }
+
+      MPI_Finalize();
 
       return EXIT_FAILURE;
    }
@@ -133,9 +216,16 @@ auto main(int argc, char** argv) -> int
    std::vector<i32> interlaced_matrix;
    if (process_id == 0)
    {
-      interlaced_matrix = interlace_matrix(matrix, process_count);
+      interlaced_matrix = interlace_matrix(
+         trace ? matrix
+               : create_random_matrix(*opts->vertex_count, opts->edges_per_vertex, opts->seed,
+                                      process_row_count),
+         process_count);
 
-      std::cout << "P0 - Scattering matrix\n";
+      if (trace)
+      {
+         std::cout << "P0 - Scattering matrix\n";
+      }
    }
 
    i32 total_size = i32(interlaced_matrix.size());
@@ -143,83 +233,256 @@ auto main(int argc, char** argv) -> int
 
    i32 local_size = total_size / process_count;
 
-   auto local_matrix = std::vector<i32>(local_size, 0);
+   i32 local_width = static_cast<i32>(std::sqrt(local_size));
+   i32 total_width = static_cast<i32>(std::sqrt(total_size));
+
+   // Each thread updates its own rows of the local matrix, and writes them first so that they are
+   // placed on its NUMA node before the scatter fills them.
+   auto team = thread_team(thread_count);
+   if (trace)
+   {
+      std::cout << "P" << process_id << " - threads = " << team.size() << "\n";
+   }
+   if (team.size() > available_cpu_count())
+   {
+      std::cout << "P" << process_id << " - warning: " << team.size() << " threads share "
+                << available_cpu_count() << " CPUs, bind the process to more cores\n";
+   }
+
+   const auto local_matrix_storage = std::make_unique_for_overwrite<i32[]>(local_size);
+   const auto local_matrix = std::span<i32>(local_matrix_storage.get(), local_size);
+   team.run([&](u32 member) {
+      const auto [first_row, last_row] = member_rows(member, team.size(), local_width);
+      std::fill(local_matrix.begin() + first_row * local_width,
+                local_matrix.begin() + last_row * local_width, 0);
+   });
+
    MPI_Scatter(interlaced_matrix.data(), local_size, MPI_INT32_T, local_matrix.data(), local_size,
                MPI_INT32_T, 0, MPI_COMM_WORLD);
 
-   std::cout << "P" << process_id << " - local matrix:\n" << format_matrix(local_matrix) << "\n";
+   if (trace)
+   {
+      std::cout << "P" << process_id << " - local matrix:\n" << format_matrix(local_matrix)
+                << "\n";
+   }
 
    i32 col_color = process_id % static_cast<i32>(std::sqrt(process_count));
    i32 row_color = std::floor(static_cast<f32>(process_id) / std::sqrt(process_count));
 
-   std::cout << "P" << process_id << " - row colour = " << row_color << "\n";
-   std::cout << "P" << process_id << " - column colour = " << col_color << "\n";
+   if (trace)
+   {
+      std::cout << "P" << process_id << " - row colour = " << row_color << "\n";
+      std::cout << "P" << process_id << " - column colour = " << col_color << "\n";
+   }
 
    MPI_Comm col_comm = {};
    MPI_Comm row_comm = {};
    MPI_Comm_split(MPI_COMM_WORLD, col_color, process_id, &col_comm);
    MPI_Comm_split(MPI_COMM_WORLD, row_color, process_id, &row_comm);
 
-   i32 local_width = static_cast<i32>(std::sqrt(local_size));
-   i32 total_width = static_cast<i32>(std::sqrt(total_size));
-   for (int k = 0; k < total_width; ++k)
-   {
-      const auto k_process_index = k / local_width;
+   // A column of the local matrix, broadcast from where it lies rather than copied out first.
+   MPI_Datatype column_type = {};
+   MPI_Type_vector(local_width, 1, local_width, MPI_INT32_T, &column_type);
+   MPI_Type_commit(&column_type);
+
+   // Iteration k receives the k-th column and row in the buffers k % 2, so that those of k + 1 can
+   // arrive while k is computed. The owners of a strip use their local matrix instead.
+   auto col_buffers = std::array<std::vector<i32>, 2>{std::vector<i32>(local_width),
+                                                      std::vector<i32>(local_width)};
+   auto row_buffers = std::array<std::vector<i32>, 2>{std::vector<i32>(local_width),
+                                                      std::vector<i32>(local_width)};
+   auto requests = std::array<MPI_Request, 2>{MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+
+   const auto owns_col = [&](int k) {
+      return k / local_width == col_color;
+   };
+   const auto owns_row = [&](int k) {
+      return k / local_width == row_color;
+   };
+
+   const auto col_of = [&](int k) -> strided_view {
+      if (owns_col(k))
+      {
+         return {local_matrix.data() + k % local_width, local_width};
+      }
+
+      return {col_buffers[k % 2].data(), 1};
+   };
+   const auto row_of = [&](int k) -> const i32* {
+      if (owns_row(k))
+      {
+         return local_matrix.data() + (k % local_width) * local_width;
+      }
+
+      return row_buffers[k % 2].data();
+   };
+
+   // The k-th column along the process row, the k-th row along the process column.
+   const auto start_broadcasts = [&](int k) {
+      const int root = k / local_width;
+      const i32 offset = k % local_width;
 
-      auto kth_col = std::vector<i32>(local_width);
-      if (k_process_index == col_color)
+      if (owns_col(k))
       {
-         const u32 col_offset = k % local_width;
-         for (u32 i = 0; i < kth_col.size(); ++i)
+         if (trace)
          {
-            kth_col[i] = local_matrix[col_offset + local_width * i];
+            std::cout << "P" << process_id << " - broadcasting " << k << "th column to rows\n";
          }
 
-         std::cout << "P" << process_id << " - broadcasting " << k << "th column to rows\n";
+         MPI_Ibcast(local_matrix.data() + offset, 1, column_type, root, row_comm, &requests[0]);
       }
+      else
+      {
+         MPI_Ibcast(col_buffers[k % 2].data(), local_width, MPI_INT32_T, root, row_comm,
+                    &requests[0]);
+      }
+
+      if (owns_row(k))
+      {
+         if (trace)
+         {
+            std::cout << "P" << process_id << " - broadcasting " << k << "th row to columns\n";
+         }
+
+         MPI_Ibcast(local_matrix.data() + offset * local_width, local_width, MPI_INT32_T, root,
+                    col_comm, &requests[1]);
+      }
+      else
+      {
+         MPI_Ibcast(row_buffers[k % 2].data(), local_width, MPI_INT32_T, root, col_comm,
+                    &requests[1]);
+      }
+   };
 
-      MPI_Bcast(kth_col.data(), local_width, MPI_INT32_T, k_process_index, row_comm);
+   // Relaxes through the k-th column and row the parts of the (k + 1)-th ones held here, so that
+   // they can be sent ahead of the rest of iteration k.
+   const auto relax_next_strips = [&](int k) {
+      const auto col = col_of(k);
+      const i32* row = row_of(k);
+      const i32 next = (k + 1) % local_width;
 
-      auto kth_row = std::vector<i32>(local_width);
-      if (k_process_index == row_color)
+      if (owns_col(k + 1))
       {
-         const u32 row_offset = k % local_width;
-         for (int i = 0; i < kth_row.size(); ++i)
+         for (i32 i = 0; i < local_width; ++i)
          {
-            kth_row[i] = local_matrix[row_offset * local_width + i];
+            i32& distance = local_matrix[i * local_width + next];
+            distance = std::min(distance, col[i] + row[next]);
          }
+      }
 
-         std::cout << "P" << process_id << " - broadcasting " << k << "th row to columns\n";
+      if (owns_row(k + 1) and reachable(col[next]))
+      {
+         min_plus_row(local_matrix.data() + next * local_width, row, col[next], local_width);
       }
+   };
 
-      MPI_Bcast(kth_row.data(), local_width, MPI_INT32_T, k_process_index, col_comm);
-      std::cout << "P" << process_id << " - Receiving " << k
-                << "th row: " << format_range(std::begin(kth_row), std::end(kth_row)) << "\n";
+   MPI_Barrier(MPI_COMM_WORLD);
+   const f64 solve_start = MPI_Wtime();
 
-      for (int j = 0; j < local_width; ++j)
+   team.run([&](u32 member) {
+      const auto [first_row, last_row] = member_rows(member, team.size(), local_width);
+
+      for (int k = 0; k < total_width; ++k)
       {
-         for (int i = 0; i < local_width; ++i)
+         const bool send_ahead = opts->pipelined and k + 1 < total_width;
+         const i32 next = (k + 1) % local_width;
+
+         if (member == 0)
          {
-            if (kth_row[j] != mark and kth_col[i] != mark)
+            if (not opts->pipelined or k == 0)
+            {
+               start_broadcasts(k);
+            }
+
+            MPI_Waitall(2, requests.data(), MPI_STATUSES_IGNORE);
+            if (trace)
+            {
+               std::cout << "P" << process_id << " - Receiving " << k << "th row: "
+                         << format_range(row_of(k), row_of(k) + local_width) << "\n";
+            }
+
+            if (send_ahead)
+            {
+               relax_next_strips(k);
+               start_broadcasts(k + 1);
+            }
+         }
+
+         team.sync();
+
+         const auto col = col_of(k);
+         const i32* row = row_of(k);
+
+         // The k-th row, read by every thread, cannot change without a negative cycle. The strips
+         // sent ahead are already relaxed and must be left alone until their broadcast is over.
+         const i32 skipped_row = owns_row(k) ? k % local_width : -1;
+         const i32 sent_row = send_ahead and owns_row(k + 1) ? next : -1;
+         const i32 sent_col = send_ahead and owns_col(k + 1) ? next : local_width;
+
+         for (int i = first_row; i < last_row; ++i)
+         {
+            if (i == skipped_row or i == sent_row or not reachable(col[i]))
+            {
+               continue;
+            }
+
+            i32* out = local_matrix.data() + i * local_width;
+            min_plus_row(out, row, col[i], sent_col);
+            if (sent_col < local_width)
+            {
+               min_plus_row(out + sent_col + 1, row + sent_col + 1, col[i],
+                            local_width - sent_col - 1);
+            }
+
+            // MPI progresses non-blocking collectives from within its calls.
+            if (member == 0 and send_ahead)
             {
-               const i32 offset = j + i * local_width;
-               local_matrix[offset] = std::min(kth_col[i] + kth_row[j], local_matrix[offset]);
+               int done = 0;
+               MPI_Testall(2, requests.data(), &done, MPI_STATUSES_IGNORE);
             }
          }
+
+         // The next column and row are read from the whole local matrix.
+         team.sync();
+
+         if (member == 0 and trace)
+         {
+            std::cout << "P" << process_id << " - local matrix:\n"
+                      << format_matrix(local_matrix) << "\n";
+         }
       }
+   });
 
-      std::cout << "P" << process_id << " - local matrix:\n" << format_matrix(local_matrix) << "\n";
-   }
+   // The slowest process bounds the solve.
+   f64 solve_time = MPI_Wtime() - solve_start;
+   MPI_Reduce(process_id == 0 ? MPI_IN_PLACE : &solve_time, &solve_time, 1, MPI_DOUBLE, MPI_MAX, 0,
+              MPI_COMM_WORLD);
+
+   MPI_Type_free(&column_type);
 
    MPI_Gather(local_matrix.data(), static_cast<i32>(local_matrix.size()), MPI_INT32_T,
               interlaced_matrix.data(), static_cast<i32>(local_matrix.size()), MPI_INT32_T, 0,
               MPI_COMM_WORLD);
 
-   if (process_id == 0)
+   if (process_id == 0 and trace)
    {
       std::cout << "\n\n"
                 << format_matrix(deinterlace_matrix(interlaced_matrix, process_count)) << "\n\n";
    }
+   else if (process_id == 0)
+   {
+      const auto distances = deinterlace_matrix(interlaced_matrix, process_count);
+      const auto summary = summarize_distances(distances.data(), static_cast<u32>(total_width),
+                                               *opts->vertex_count);
+
+      std::cout << "vertices: " << *opts->vertex_count << " (padded to " << total_width << ")\n";
+      std::cout << "processes: " << process_count << ", threads per process: " << team.size()
+                << (opts->pipelined ? ", pipelined" : "") << "\n";
+      std::cout << "min-plus kernel: " << min_plus_kernel_name() << "\n";
+      std::cout << "solve time: " << solve_time << " s\n";
+      std::cout << "reachable pairs: " << summary.reachable_pairs << "\n";
+      std::cout << "distance sum: " << summary.distance_sum << "\n";
+   }
 
    MPI_Finalize();
 
@@ -289,11 +552,11 @@ auto deinterlace_matrix(const std::vector<i32>& m, i32 process_count) -> std::ve
 template <typename It>
 auto format_range(It begin, It end) -> std::string
 {
-   using type = typename It::value_type;
+   using type = std::iter_value_t<It>;
 
    std::string str = " ";
    std::for_each(begin, end, [&](const type& val) {
-      if (val == mark)
+      if (not reachable(val))
       {
          str += "_ ";
       }
@@ -306,7 +569,7 @@ auto format_range(It begin, It end) -> std::string
 
    return str;
 }
-auto format_matrix(const std::vector<i32>& matrix) -> std::string
+auto format_matrix(std::span<const i32> matrix) -> std::string
 {
    const auto width = static_cast<i32>(std::sqrt(matrix.size()));
 
@@ -320,7 +583,7 @@ auto format_matrix(const std::vector<i32>& matrix) -> std::string
          i = 0;
       }
 
-      if (val == mark)
+      if (not reachable(val))
       {
          str += "_ ";
       }
@@ -339,3 +602,38 @@ auto is_power_of_2(i32 n) -> bool
 {
    return n && !(n & (n - 1));
 }
+
+auto is_perfect_square(i32 n) -> bool
+{
+   const auto root = static_cast<i32>(std::lround(std::sqrt(n)));
+
+   return root * root == n;
+}
+
+// A random graph of `vertex_count` vertices, padded with isolated vertices to a multiple of
+// `padding` so that it splits evenly over the process grid.
+auto create_random_matrix(u32 vertex_count, u32 edges_per_vertex, u64 seed, u32 padding)
+   -> std::vector<i32>
+{
+   const u32 width = (vertex_count + padding - 1) / padding * padding;
+
+   auto result = std::vector<i32>(static_cast<std::size_t>(width) * width, tombstone);
+   for (u32 i = 0; i < width; ++i)
+   {
+      result[static_cast<std::size_t>(i) * width + i] = 0;
+   }
+
+   add_random_edges(result.data(), width, vertex_count, edges_per_vertex, seed);
+
+   return result;
+}
+
+// The rows [first, last) of a team member, contiguous, the first members taking one extra row.
+auto member_rows(u32 member, u32 member_count, i32 row_count) -> std::pair<i32, i32>
+{
+   const i32 share = row_count / static_cast<i32>(member_count);
+   const i32 extra = row_count % static_cast<i32>(member_count);
+   const i32 first = static_cast<i32>(member) * share + std::min(static_cast<i32>(member), extra);
+
+   return {first, first + share + (static_cast<i32>(member) < extra ? 1 : 0)};
+}
@@ -0,0 +1,15 @@
+#ifndef PARALLEL_FLOYD_WARSHALL_TYPES_HPP_
+#define PARALLEL_FLOYD_WARSHALL_TYPES_HPP_
+
+#include <cstdint>
+
+using i32 = std::int32_t;
+using i64 = std::int64_t;
+
+using u32 = std::uint32_t;
+using u64 = std::uint64_t;
+
+using f32 = float;
+using f64 = double;
+
+#endif // PARALLEL_FLOYD_WARSHALL_TYPES_HPP_
@@ -0,0 +1,304 @@
+#include <parallel-pi/benchmark.hpp>
+
+#include <libmonte-carlo/circle_hits.hpp>
+#include <libmonte-carlo/monte_carlo.hpp>
+#include <libmonte-carlo/monte_carlo_mpi.hpp>
+#include <libmonte-carlo/philox.hpp>
+#include <libmonte-carlo/sampling_team.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <mpi.h>
+
+namespace
+{
+   // An MPI_Barrier that sleeps rather than spins, leaving the CPUs to the ranks being measured
+   // while the others wait for them.
+   void idle_barrier(MPI_Comm communicator)
+   {
+      MPI_Request request = MPI_REQUEST_NULL;
+      MPI_Ibarrier(communicator, &request);
+
+      int done = 0;
+      MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+      while (done == 0)
+      {
+         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+         MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+      }
+   }
+
+   struct measurement
+   {
+      u32 rank_count = 1;
+      u32 thread_count = 1;
+      u64 batch_size = 0;
+      u64 sample_count = 0;
+
+      f64 elapsed = 0.0;   // of the slowest rank
+      f64 sampling = 0.0;  // mean over the ranks
+      f64 reduction = 0.0; // mean over the ranks
+      f64 efficiency = 0.0;
+
+      [[nodiscard]] auto samples_per_second() const -> f64
+      {
+         return static_cast<f64>(sample_count) / elapsed;
+      }
+      [[nodiscard]] auto samples_per_core_second() const -> f64
+      {
+         return samples_per_second() / static_cast<f64>(rank_count * thread_count);
+      }
+   };
+
+   auto default_rank_counts(u32 process_count) -> std::vector<u32>
+   {
+      std::vector<u32> rank_counts;
+      for (u32 count = 1; count < process_count; count *= 2)
+      {
+         rank_counts.push_back(count);
+      }
+      rank_counts.push_back(process_count);
+
+      return rank_counts;
+   }
+
+   // Every rank of `communicator` samples one batch per thread and per round, and the statistics
+   // are reduced after each round, as in the blocking mode of the estimator. The fastest of the
+   // repetitions is kept.
+   template <typename Estimator>
+   auto measure(const Estimator& estimator, u32 thread_count, u64 batch_count, u32 repetitions,
+                MPI_Comm communicator, const monte_carlo::statistics_reduction& reduction)
+      -> measurement
+   {
+      int rank = 0;
+      int rank_count = 0;
+      MPI_Comm_rank(communicator, &rank);
+      MPI_Comm_size(communicator, &rank_count);
+
+      auto team = monte_carlo::threaded_backend<Estimator>(estimator, thread_count);
+
+      const u64 batches_per_round = static_cast<u64>(rank_count) * team.size();
+
+      measurement result{.rank_count = static_cast<u32>(rank_count),
+                         .thread_count = team.size(),
+                         .batch_size = estimator.batch_size(),
+                         .sample_count = batch_count * estimator.batch_size(),
+                         .elapsed = std::numeric_limits<f64>::infinity()};
+
+      for (u32 repetition = 0; repetition < repetitions; ++repetition)
+      {
+         MPI_Barrier(communicator);
+
+         // {elapsed, sampling, reduction}
+         std::array<f64, 3> times = {0.0, 0.0, 0.0};
+
+         const f64 start = MPI_Wtime();
+         for (u64 first_batch = 0; first_batch < batch_count; first_batch += batches_per_round)
+         {
+            const f64 sampling_start = MPI_Wtime();
+            const monte_carlo::round_statistics local_round = {
+               .statistics =
+                  team.sample(first_batch + static_cast<u64>(rank) * team.size(), team.size())};
+
+            const f64 reduction_start = MPI_Wtime();
+            monte_carlo::round_statistics round;
+            MPI_Allreduce(&local_round, &round, 1, reduction.type, reduction.op, communicator);
+
+            times[1] += reduction_start - sampling_start;
+            times[2] += MPI_Wtime() - reduction_start;
+         }
+         times[0] = MPI_Wtime() - start;
+
+         std::array<f64, 3> slowest = {};
+         std::array<f64, 3> total = {};
+         MPI_Reduce(times.data(), slowest.data(), 3, MPI_DOUBLE, MPI_MAX, 0, communicator);
+         MPI_Reduce(times.data(), total.data(), 3, MPI_DOUBLE, MPI_SUM, 0, communicator);
+
+         if (slowest[0] < result.elapsed)
+         {
+            result.elapsed = slowest[0];
+            result.sampling = total[1] / rank_count;
+            result.reduction = total[2] / rank_count;
+         }
+      }
+
+      return result;
+   }
+
+   template <typename MakeSampler>
+   auto sweep(const options& opts, MakeSampler make_sampler, std::span<const u32> rank_counts,
+              int process_id) -> std::vector<measurement>
+   {
+      const auto& benchmark = opts.benchmark;
+
+      auto reduction = monte_carlo::make_statistics_reduction();
+
+      // Every rank must run the same configurations, whatever CPUs it was given.
+      const u32 cpu_count = monte_carlo::agreed_thread_count(0, MPI_COMM_WORLD);
+
+      std::vector<measurement> results;
+      for (const u64 batch_size : benchmark.batch_sizes)
+      {
+         const auto estimator =
+            monte_carlo::estimator<2, monte_carlo::circle_indicator,
+                                   decltype(make_sampler(batch_size)),
+                                   monte_carlo::stratified_box<2>>(
+               {}, make_sampler(batch_size),
+               monte_carlo::stratified_box<2>({0.0, 0.0}, {1.0, 1.0}, opts.strata), batch_size);
+
+         // One thread on one rank comes first, as the reference of the efficiency.
+         std::vector<std::pair<u32, u32>> configurations = {{1, 1}};
+         for (const u32 rank_count : rank_counts)
+         {
+            for (const u32 requested_threads : benchmark.thread_counts)
+            {
+               const u32 thread_count =
+                  requested_threads == 0 ? cpu_count : requested_threads;
+
+               if (rank_count != 1 or thread_count != 1)
+               {
+                  configurations.emplace_back(rank_count, thread_count);
+               }
+            }
+         }
+
+         f64 reference = 0.0;
+         for (const auto& [rank_count, thread_count] : configurations)
+         {
+            const u64 cores = static_cast<u64>(rank_count) * thread_count;
+            const u64 samples =
+               benchmark.mode == scaling::strong ? benchmark.samples : benchmark.samples * cores;
+
+            // Whole rounds of one batch per core.
+            const u64 round_count = std::max<u64>((samples + batch_size * cores - 1) /
+                                                     (batch_size * cores),
+                                                  1);
+
+            MPI_Comm communicator = MPI_COMM_NULL;
+            MPI_Comm_split(MPI_COMM_WORLD,
+                           static_cast<u32>(process_id) < rank_count ? 0 : MPI_UNDEFINED,
+                           process_id, &communicator);
+
+            if (communicator != MPI_COMM_NULL)
+            {
+               auto result = measure(estimator, thread_count, round_count * cores,
+                                     benchmark.repetitions, communicator, reduction);
+
+               if (reference == 0.0)
+               {
+                  reference = result.samples_per_core_second();
+               }
+               result.efficiency = result.samples_per_core_second() / reference;
+
+               results.push_back(result);
+
+               MPI_Comm_free(&communicator);
+            }
+
+            idle_barrier(MPI_COMM_WORLD);
+         }
+      }
+
+      monte_carlo::free_statistics_reduction(reduction);
+
+      return results;
+   }
+
+   void write_csv(std::span<const measurement> results, scaling mode)
+   {
+      std::cout << "scaling,ranks,threads,batch_size,samples,elapsed_s,sampling_s,reduction_s,"
+                   "samples_per_s,samples_per_core_s,efficiency\n";
+
+      for (const auto& result : results)
+      {
+         std::cout << (mode == scaling::strong ? "strong" : "weak") << ',' << result.rank_count
+                   << ',' << result.thread_count << ',' << result.batch_size << ','
+                   << result.sample_count << ',' << result.elapsed << ',' << result.sampling
+                   << ',' << result.reduction << ',' << result.samples_per_second() << ','
+                   << result.samples_per_core_second() << ',' << result.efficiency << '\n';
+      }
+   }
+
+   void write_json(std::span<const measurement> results, const options& opts, u64 seed)
+   {
+      std::cout << "{\n";
+      std::cout << "  \"seed\": " << seed << ",\n";
+      std::cout << "  \"sampler\": \""
+                << (opts.sampling == sampler::sobol ? "sobol" : "philox") << "\",\n";
+      std::cout << "  \"strata\": " << opts.strata << ",\n";
+      std::cout << "  \"scaling\": \""
+                << (opts.benchmark.mode == scaling::strong ? "strong" : "weak") << "\",\n";
+      std::cout << "  \"simd_kernel\": \"" << circle_hits_kernel_name() << "\",\n";
+      std::cout << "  \"rng_kernel\": \"" << philox_kernel_name() << "\",\n";
+      std::cout << "  \"results\": [";
+
+      for (std::size_t i = 0; i < results.size(); ++i)
+      {
+         const auto& result = results[i];
+
+         std::cout << (i == 0 ? "\n" : ",\n") << "    {\"ranks\": " << result.rank_count
+                   << ", \"threads\": " << result.thread_count
+                   << ", \"batch_size\": " << result.batch_size
+                   << ", \"samples\": " << result.sample_count
+                   << ", \"elapsed_s\": " << result.elapsed
+                   << ", \"sampling_s\": " << result.sampling
+                   << ", \"reduction_s\": " << result.reduction
+                   << ", \"samples_per_s\": " << result.samples_per_second()
+                   << ", \"samples_per_core_s\": " << result.samples_per_core_second()
+                   << ", \"efficiency\": " << result.efficiency << '}';
+      }
+
+      std::cout << "\n  ]\n}\n";
+   }
+} // namespace
+
+auto run_benchmark(const options& opts, u64 seed) -> std::expected<void, std::string>
+{
+   int process_id = 0;
+   int process_count = 0;
+   MPI_Comm_rank(MPI_COMM_WORLD, &process_id);
+   MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+
+   const auto rank_counts = opts.benchmark.rank_counts.empty()
+      ? default_rank_counts(static_cast<u32>(process_count))
+      : opts.benchmark.rank_counts;
+
+   for (const u32 rank_count : rank_counts)
+   {
+      if (rank_count > static_cast<u32>(process_count))
+      {
+         return std::unexpected("--rank-counts cannot exceed the " +
+                                std::to_string(process_count) + " ranks of the job");
+      }
+   }
+
+   const auto results = opts.sampling == sampler::sobol
+      ? sweep(
+           opts, [&](u64 batch_size) { return monte_carlo::sobol_sampler(seed, batch_size); },
+           rank_counts, process_id)
+      : sweep(
+           opts,
+           [&](u64 batch_size) { return monte_carlo::philox_sampler<2>(seed, batch_size); },
+           rank_counts, process_id);
+
+   if (process_id == 0)
+   {
+      if (opts.benchmark.format == report_format::json)
+      {
+         write_json(results, opts, seed);
+      }
+      else
+      {
+         write_csv(results, opts.benchmark.mode);
+      }
+   }
+
+   return {};
+}
@@ -0,0 +1,19 @@
+#ifndef PARALLEL_PI_BENCHMARK_HPP_
+#define PARALLEL_PI_BENCHMARK_HPP_
+
+#include <parallel-pi/options.hpp>
+#include <parallel-pi/types.hpp>
+
+#include <expected>
+#include <string>
+
+/**
+ * Samples a fixed number of batches for every combination of batch size, rank count and thread
+ * count of `opts.benchmark`, and writes one row per combination to the standard output of rank
+ * 0: the time spent sampling and reducing, the throughput per core and the parallel efficiency
+ * relative to a single thread on a single rank. Rank counts below the job size run on a
+ * sub-communicator, the other ranks wait for the next measurement. Every rank must call it.
+ */
+auto run_benchmark(const options& opts, u64 seed) -> std::expected<void, std::string>;
+
+#endif // PARALLEL_PI_BENCHMARK_HPP_
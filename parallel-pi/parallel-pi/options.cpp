@@ -0,0 +1,304 @@
+#include <parallel-pi/options.hpp>
+
+#include <charconv>
+#include <string_view>
+
+namespace
+{
+   template <typename T>
+   auto parse_number(std::string_view name, std::string_view text) -> std::expected<T, std::string>
+   {
+      T value{};
+      const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+      if (error != std::errc() or end != text.data() + text.size())
+      {
+         return std::unexpected("invalid value '" + std::string(text) + "' for " +
+                                std::string(name));
+      }
+
+      return value;
+   }
+
+   // Parses the value following the option at `args[i]` and moves `i` past it.
+   template <typename T>
+   auto next_number(std::span<char*> args, std::size_t& i) -> std::expected<T, std::string>
+   {
+      const std::string_view name = args[i];
+      if (i + 1 >= args.size())
+      {
+         return std::unexpected("missing value for " + std::string(name));
+      }
+
+      return parse_number<T>(name, args[++i]);
+   }
+
+   // Parses the comma separated values following the option at `args[i]` and moves `i` past them.
+   template <typename T>
+   auto next_numbers(std::span<char*> args, std::size_t& i)
+      -> std::expected<std::vector<T>, std::string>
+   {
+      const std::string_view name = args[i];
+      if (i + 1 >= args.size())
+      {
+         return std::unexpected("missing value for " + std::string(name));
+      }
+
+      std::vector<T> values;
+
+      std::string_view text = args[++i];
+      while (true)
+      {
+         const std::size_t comma = text.find(',');
+
+         const auto value = parse_number<T>(name, text.substr(0, comma));
+         if (not value)
+         {
+            return std::unexpected(value.error());
+         }
+         if (*value == 0)
+         {
+            return std::unexpected("values of " + std::string(name) + " must be positive");
+         }
+
+         values.push_back(*value);
+
+         if (comma == std::string_view::npos)
+         {
+            return values;
+         }
+
+         text.remove_prefix(comma + 1);
+      }
+   }
+
+   auto divides_batches(u64 strata, u64 batch_size) -> bool
+   {
+      return strata <= batch_size and batch_size % (strata * strata) == 0;
+   }
+} // namespace
+
+auto parse_options(std::span<char*> args) -> std::expected<options, std::string>
+{
+   options result;
+
+   for (std::size_t i = 1; i < args.size(); ++i)
+   {
+      const std::string_view arg = args[i];
+
+      if (arg == "--seed")
+      {
+         const auto seed = next_number<u64>(args, i);
+         if (not seed)
+         {
+            return std::unexpected(seed.error());
+         }
+
+         result.seed = *seed;
+      }
+      else if (arg == "--sampler")
+      {
+         const std::string_view name = i + 1 < args.size() ? args[++i] : "";
+         if (name == "philox")
+         {
+            result.sampling = sampler::pseudo_random;
+         }
+         else if (name == "sobol")
+         {
+            result.sampling = sampler::sobol;
+         }
+         else
+         {
+            return std::unexpected("--sampler must be one of philox, sobol");
+         }
+      }
+      else if (arg == "--batch-size")
+      {
+         const auto batch_size = next_number<u64>(args, i);
+         if (not batch_size)
+         {
+            return std::unexpected(batch_size.error());
+         }
+         if (*batch_size == 0)
+         {
+            return std::unexpected("--batch-size must be positive");
+         }
+
+         result.batch_size = *batch_size;
+      }
+      else if (arg == "--strata")
+      {
+         const auto strata = next_number<u64>(args, i);
+         if (not strata)
+         {
+            return std::unexpected(strata.error());
+         }
+         if (*strata == 0)
+         {
+            return std::unexpected("--strata must be positive");
+         }
+
+         result.strata = *strata;
+      }
+      else if (arg == "--tolerance")
+      {
+         const auto tolerance = next_number<f64>(args, i);
+         if (not tolerance)
+         {
+            return std::unexpected(tolerance.error());
+         }
+         if (*tolerance <= 0.0)
+         {
+            return std::unexpected("--tolerance must be positive");
+         }
+
+         result.tolerance = *tolerance;
+      }
+      else if (arg == "--threads")
+      {
+         const auto thread_count = next_number<u32>(args, i);
+         if (not thread_count)
+         {
+            return std::unexpected(thread_count.error());
+         }
+
+         result.thread_count = *thread_count;
+      }
+      else if (arg == "--overlap")
+      {
+         result.overlap = true;
+      }
+      else if (arg == "--reduction-fraction")
+      {
+         const auto fraction = next_number<f64>(args, i);
+         if (not fraction)
+         {
+            return std::unexpected(fraction.error());
+         }
+         if (*fraction <= 0.0 or *fraction >= 1.0)
+         {
+            return std::unexpected("--reduction-fraction must be between 0 and 1");
+         }
+
+         result.reduction_fraction = *fraction;
+      }
+      else if (arg == "--benchmark")
+      {
+         result.benchmark.enabled = true;
+      }
+      else if (arg == "--scaling")
+      {
+         const std::string_view name = i + 1 < args.size() ? args[++i] : "";
+         if (name == "strong")
+         {
+            result.benchmark.mode = scaling::strong;
+         }
+         else if (name == "weak")
+         {
+            result.benchmark.mode = scaling::weak;
+         }
+         else
+         {
+            return std::unexpected("--scaling must be one of strong, weak");
+         }
+      }
+      else if (arg == "--format")
+      {
+         const std::string_view name = i + 1 < args.size() ? args[++i] : "";
+         if (name == "csv")
+         {
+            result.benchmark.format = report_format::csv;
+         }
+         else if (name == "json")
+         {
+            result.benchmark.format = report_format::json;
+         }
+         else
+         {
+            return std::unexpected("--format must be one of csv, json");
+         }
+      }
+      else if (arg == "--batch-sizes")
+      {
+         const auto batch_sizes = next_numbers<u64>(args, i);
+         if (not batch_sizes)
+         {
+            return std::unexpected(batch_sizes.error());
+         }
+
+         result.benchmark.batch_sizes = *batch_sizes;
+      }
+      else if (arg == "--rank-counts")
+      {
+         const auto rank_counts = next_numbers<u32>(args, i);
+         if (not rank_counts)
+         {
+            return std::unexpected(rank_counts.error());
+         }
+
+         result.benchmark.rank_counts = *rank_counts;
+      }
+      else if (arg == "--thread-counts")
+      {
+         const auto thread_counts = next_numbers<u32>(args, i);
+         if (not thread_counts)
+         {
+            return std::unexpected(thread_counts.error());
+         }
+
+         result.benchmark.thread_counts = *thread_counts;
+      }
+      else if (arg == "--samples")
+      {
+         const auto samples = next_number<u64>(args, i);
+         if (not samples)
+         {
+            return std::unexpected(samples.error());
+         }
+         if (*samples == 0)
+         {
+            return std::unexpected("--samples must be positive");
+         }
+
+         result.benchmark.samples = *samples;
+      }
+      else if (arg == "--repetitions")
+      {
+         const auto repetitions = next_number<u32>(args, i);
+         if (not repetitions)
+         {
+            return std::unexpected(repetitions.error());
+         }
+         if (*repetitions == 0)
+         {
+            return std::unexpected("--repetitions must be positive");
+         }
+
+         result.benchmark.repetitions = *repetitions;
+      }
+      else
+      {
+         return std::unexpected("unknown option " + std::string(arg));
+      }
+   }
+
+   if (result.benchmark.batch_sizes.empty())
+   {
+      result.benchmark.batch_sizes.push_back(result.batch_size);
+   }
+   if (result.benchmark.thread_counts.empty())
+   {
+      result.benchmark.thread_counts.push_back(result.thread_count);
+   }
+
+   // Every batch must cover each stratum the same number of times.
+   for (const u64 batch_size : result.benchmark.batch_sizes)
+   {
+      if (not divides_batches(result.strata, batch_size) or
+          not divides_batches(result.strata, result.batch_size))
+      {
+         return std::unexpected("--strata squared must divide the batch sizes");
+      }
+   }
+
+   return result;
+}
@@ -0,0 +1,76 @@
+#ifndef PARALLEL_PI_OPTIONS_HPP_
+#define PARALLEL_PI_OPTIONS_HPP_
+
+#include <parallel-pi/types.hpp>
+
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+// Default number of samples drawn in one batch. Batches are the unit of work handed to ranks and
+// threads, and batch b of a seed always draws the same samples.
+inline constexpr u64 sample_count = 10000;
+
+enum class sampler
+{
+   pseudo_random, // Philox streams, one per batch
+   sobol          // contiguous slices of a scrambled Sobol sequence, one per batch
+};
+
+enum class scaling
+{
+   strong, // the same total work at every rank and thread count
+   weak    // the same work per core at every rank and thread count
+};
+
+enum class report_format
+{
+   csv,
+   json
+};
+
+// Fixed-work measurements over a sweep of batch sizes, rank counts and thread counts.
+struct benchmark_options
+{
+   bool enabled = false;
+   scaling mode = scaling::strong;
+   report_format format = report_format::csv;
+
+   std::vector<u64> batch_sizes;   // defaults to options::batch_size
+   std::vector<u32> rank_counts;   // defaults to the powers of two up to the job size, and the size
+   std::vector<u32> thread_counts; // defaults to options::thread_count, 0 is again every CPU
+
+   u64 samples = 100'000'000;      // in total for strong scaling, per core for weak scaling
+   u32 repetitions = 3;            // the fastest one is reported
+};
+
+struct options
+{
+   std::optional<u64> seed;
+   sampler sampling = sampler::pseudo_random;
+
+   u64 batch_size = sample_count;
+
+   // The unit square is split into strata x strata cells sampled equally by every batch, the
+   // cell count must divide the batch size.
+   u64 strata = 1;
+
+   // Sampling stops once the 95% confidence interval of the estimate is within this of it.
+   f64 tolerance = 1e-4;
+
+   // Sampling threads per rank, 0 starts one per CPU available to the rank.
+   u32 thread_count = 1;
+
+   // Sample the next round while the previous reduction is in flight, adapting the round size so
+   // that waiting on reductions takes about `reduction_fraction` of the run time.
+   bool overlap = false;
+   f64 reduction_fraction = 0.05;
+
+   benchmark_options benchmark;
+};
+
+auto parse_options(std::span<char*> args) -> std::expected<options, std::string>;
+
+#endif // PARALLEL_PI_OPTIONS_HPP_
@@ -1,84 +1,115 @@
-#include <cstdint>
+#include <parallel-pi/benchmark.hpp>
+#include <parallel-pi/options.hpp>
+#include <parallel-pi/types.hpp>
+
+#include <libmonte-carlo/circle_hits.hpp>
+#include <libmonte-carlo/monte_carlo.hpp>
+#include <libmonte-carlo/monte_carlo_mpi.hpp>
+#include <libmonte-carlo/philox.hpp>
+#include <libmonte-carlo/running_statistics.hpp>
+#include <libmonte-carlo/sampling_team.hpp>
+
+#include <algorithm>
+#include <cstddef>
 #include <iostream>
-#include <limits>
 #include <random>
 
 #include <mpi.h>
 
-using u16 = std::uint16_t;
-using u32 = std::uint32_t;
-using u64 = std::uint64_t;
-using f64 = double;
-
-static constexpr u64 sample_count = 10000;
-static constexpr f64 circle_center = 0.5;
-static constexpr f64 circle_radius = 0.5;
-static constexpr f64 desired_pi = 3.141592;
-static constexpr f64 convergence_epsilon = 0.000001;
+// Bounds the rounds of the overlapped mode, per sampling thread, which must stay short enough for
+// the convergence check to be taken often.
+static constexpr u64 max_batches_per_round = 16;
 
-auto is_within_circle(f64 x, f64 y) -> bool
+struct estimate
 {
-   const f64 x_dir = circle_center - x;
-   const f64 y_dir = circle_center - y;
-
-   const f64 distance_to_center = std::sqrt(x_dir * x_dir + y_dir * y_dir);
-
-   return distance_to_center <= circle_radius;
-}
+   running_statistics statistics;
+   u32 thread_count = 1;
+   u64 reduction_count = 0;
+   u64 batches_per_round = 1;
+};
 
-auto is_converging(f64 value) -> bool
-{
-   const f64 adjusted_value = value - desired_pi;
+template <typename Sampler>
+auto run(const options& opts, Sampler sampler, int process_id, int process_count) -> estimate;
 
-   return adjusted_value < convergence_epsilon and adjusted_value > -convergence_epsilon;
-}
+template <typename Team>
+auto run_overlapped(Team& team, const monte_carlo::statistics_reduction& reduction, f64 tolerance,
+                    f64 reduction_fraction, int process_id, int process_count) -> estimate;
 
 auto main(int argc, char *argv[]) -> int
 {
    int process_id = 0;
    int process_count = 0;
 
-   MPI_Init(&argc, &argv);
+   // Only the main thread of a rank talks to MPI, the sampling threads never do.
+   int thread_support = 0;
+   MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &thread_support);
 
    const f64 start_time = MPI_Wtime();
 
    MPI_Comm_size(MPI_COMM_WORLD, &process_count);
    MPI_Comm_rank(MPI_COMM_WORLD, &process_id);
 
-   std::random_device rd;
-   auto random_engine = std::default_random_engine(rd());
-   auto distribution = std::uniform_real_distribution<f64>(circle_center - circle_radius,
-                                                           circle_center + circle_radius);
-
-   u64 total_iteration_count = 0;
-   u64 local_iteration_count = 1;
-   u64 total_circle_hits = 0;
-   u64 local_circle_hits = 0;
-   f64 pi = 0.0;
-   do
+   const auto opts = parse_options({argv, static_cast<std::size_t>(argc)});
+   if (not opts)
    {
-      for (u64 i = 0; i < sample_count; ++i)
+      if (process_id == 0)
       {
-         const f64 x = distribution(random_engine);
-         const f64 y = distribution(random_engine);
+         std::cout << "error: " << opts.error() << '\n';
+      }
+
+      MPI_Finalize();
+
+      return EXIT_FAILURE;
+   }
+
+   // Sampling threads run beside the main thread while it calls MPI.
+   const bool threaded = opts->thread_count != 1 or
+      std::ranges::any_of(opts->benchmark.thread_counts, [](u32 count) { return count != 1; });
+   if (threaded and thread_support < MPI_THREAD_FUNNELED)
+   {
+      if (process_id == 0)
+      {
+         std::cout << "error: sampling threads need MPI_THREAD_FUNNELED, which this MPI does not "
+                      "provide; run with --threads 1\n";
+      }
+
+      MPI_Finalize();
+
+      return EXIT_FAILURE;
+   }
 
-         if (is_within_circle(x, y))
+   u64 seed = 0;
+   if (process_id == 0)
+   {
+      std::random_device rd;
+      seed = opts->seed.value_or((static_cast<u64>(rd()) << 32) | rd());
+   }
+
+   MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+   if (opts->benchmark.enabled)
+   {
+      const auto report = run_benchmark(*opts, seed);
+
+      MPI_Finalize();
+
+      if (not report)
+      {
+         if (process_id == 0)
          {
-            ++local_circle_hits;
+            std::cout << "error: " << report.error() << '\n';
          }
-      }
 
-      MPI_Allreduce(&local_circle_hits, &total_circle_hits, 1, MPI_UINT64_T, MPI_SUM,
-                    MPI_COMM_WORLD);
-      MPI_Allreduce(&local_iteration_count, &total_iteration_count, 1, MPI_UINT64_T, MPI_SUM,
-                    MPI_COMM_WORLD);
+         return EXIT_FAILURE;
+      }
 
-      // NOLINTNEXTLINE
-      pi = 4.0f * static_cast<f64>(total_circle_hits) /
-         static_cast<f64>(sample_count * total_iteration_count);
+      return EXIT_SUCCESS;
+   }
 
-      ++local_iteration_count;
-   } while (not is_converging(pi));
+   const auto result = opts->sampling == sampler::sobol
+      ? run(*opts, monte_carlo::sobol_sampler(seed, opts->batch_size), process_id, process_count)
+      : run(*opts, monte_carlo::philox_sampler<2>(seed, opts->batch_size), process_id,
+            process_count);
 
    const f64 elapsed_time = MPI_Wtime() - start_time;
 
@@ -86,11 +117,140 @@ auto main(int argc, char *argv[]) -> int
 
    if (process_id == 0)
    {
-      std::cout << "iteration to converge: " << total_iteration_count << '\n';
-      std::cout << "total samples: " << total_iteration_count * sample_count << '\n';
-      std::cout << "result: " << pi << '\n';
+      std::cout << "seed: " << seed << '\n';
+      std::cout << "sampler: " << (opts->sampling == sampler::sobol ? "sobol" : "philox") << '\n';
+      std::cout << "strata: " << opts->strata << 'x' << opts->strata << '\n';
+      std::cout << "threads per rank: " << result.thread_count << '\n';
+      std::cout << "simd kernel: " << circle_hits_kernel_name() << " (rng: "
+                << philox_kernel_name() << ")\n";
+      if (opts->overlap)
+      {
+         std::cout << "reductions: " << result.reduction_count
+                   << " (final round: " << result.batches_per_round << " batches per thread)\n";
+      }
+      std::cout << "iteration to converge: " << result.statistics.count << '\n';
+      std::cout << "total samples: " << result.statistics.count * opts->batch_size << '\n';
+      std::cout << "result: " << result.statistics.mean << " +/- "
+                << result.statistics.half_width() << '\n';
       std::cout << "elapsed time: " << elapsed_time << '\n';
    }
 
    return EXIT_SUCCESS;
 }
+
+// Batches are numbered globally, round after round, so a given seed yields the same samples for
+// the first n batches of the job whatever the number of ranks.
+template <typename Sampler>
+auto run(const options& opts, Sampler sampler, int process_id, int process_count) -> estimate
+{
+   const auto estimator = monte_carlo::estimator<2, monte_carlo::circle_indicator, Sampler,
+                                                 monte_carlo::stratified_box<2>>(
+      {}, sampler, monte_carlo::stratified_box<2>({0.0, 0.0}, {1.0, 1.0}, opts.strata),
+      opts.batch_size);
+
+   auto team = monte_carlo::threaded_backend<decltype(estimator)>(
+      estimator, monte_carlo::agreed_thread_count(opts.thread_count, MPI_COMM_WORLD));
+
+   auto reduction = monte_carlo::make_statistics_reduction();
+
+   estimate result;
+   if (opts.overlap)
+   {
+      result = run_overlapped(team, reduction, opts.tolerance, opts.reduction_fraction, process_id,
+                              process_count);
+   }
+   else
+   {
+      // One batch per thread and per rank in each round.
+      auto backend = monte_carlo::mpi_backend(team, reduction, MPI_COMM_WORLD);
+
+      result.statistics = monte_carlo::integrate(backend, opts.tolerance);
+      result.reduction_count = backend.reduction_count();
+   }
+   result.thread_count = team.size();
+
+   monte_carlo::free_statistics_reduction(reduction);
+
+   return result;
+}
+
+// Round r + 1 is sampled while the reduction of the counts up to round r is in flight, and the
+// convergence decision for round r is taken once it lands, so sampling never waits on the
+// collective unless the collective is slower than a round. Every rank derives the next round size
+// from the same reduced timings, which keeps the global batch numbering consistent.
+template <typename Team>
+auto run_overlapped(Team& team, const monte_carlo::statistics_reduction& reduction, f64 tolerance,
+                    f64 reduction_fraction, int process_id, int process_count) -> estimate
+{
+   const auto nanoseconds_since = [](f64 start) {
+      return static_cast<u64>((MPI_Wtime() - start) * 1e9);
+   };
+
+   // The statistics and the timings of a round travel in one reduction, so a round costs a
+   // single collective.
+   monte_carlo::round_statistics local_round;
+   monte_carlo::round_statistics in_flight_round;
+   monte_carlo::round_statistics total_round;
+   monte_carlo::round_statistics previous_total_round;
+
+   MPI_Request request = MPI_REQUEST_NULL;
+
+   // Rounds are sized in whole batches per thread.
+   const u64 thread_count = team.size();
+
+   estimate result;
+   u64 round_first_batch = 0;
+   while (true)
+   {
+      const u64 batches_per_round = result.batches_per_round * thread_count;
+
+      const f64 sampling_start = MPI_Wtime();
+      local_round.statistics.merge(team.sample(
+         round_first_batch + static_cast<u64>(process_id) * batches_per_round, batches_per_round));
+      local_round.sampling_ns += nanoseconds_since(sampling_start);
+
+      round_first_batch += static_cast<u64>(process_count) * batches_per_round;
+
+      if (request != MPI_REQUEST_NULL)
+      {
+         const f64 waiting_start = MPI_Wtime();
+         MPI_Wait(&request, MPI_STATUS_IGNORE);
+         local_round.waiting_ns += nanoseconds_since(waiting_start);
+
+         ++result.reduction_count;
+         result.statistics = total_round.statistics;
+
+         if (is_converging(result.statistics, tolerance))
+         {
+            break;
+         }
+
+         const auto sampled =
+            static_cast<f64>(total_round.sampling_ns - previous_total_round.sampling_ns);
+         const auto waited =
+            static_cast<f64>(total_round.waiting_ns - previous_total_round.waiting_ns);
+         const f64 fraction = waited / std::max(sampled + waited, 1.0);
+
+         // Grow quickly while collectives dominate, shrink gently to keep convergence checks
+         // frequent once they are hidden.
+         if (fraction > reduction_fraction)
+         {
+            result.batches_per_round =
+               std::min(2 * result.batches_per_round, max_batches_per_round);
+         }
+         else if (fraction < reduction_fraction / 4 and result.batches_per_round > 1)
+         {
+            result.batches_per_round -= std::max<u64>(result.batches_per_round / 4, 1);
+         }
+
+         previous_total_round = total_round;
+      }
+
+      // The send buffer must stay untouched while the reduction is in flight.
+      in_flight_round = local_round;
+      MPI_Iallreduce(&in_flight_round, &total_round, 1, reduction.type, reduction.op,
+                     MPI_COMM_WORLD, &request);
+   }
+
+   return result;
+}
@@ -0,0 +1,253 @@
+#include <parallel-qsort/benchmark/benchmark_options.hpp>
+
+#include <charconv>
+#include <optional>
+
+namespace
+{
+   template <typename T>
+   auto parse_number(std::string_view name, std::string_view text) -> std::expected<T, std::string>
+   {
+      T value{};
+      const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+      if (error != std::errc() or end != text.data() + text.size())
+      {
+         return std::unexpected("invalid value '" + std::string(text) + "' for " +
+                                std::string(name));
+      }
+
+      return value;
+   }
+
+   // The value following the option at `args[i]`, moving `i` past it.
+   auto next_string(std::span<char*> args, std::size_t& i)
+      -> std::expected<std::string_view, std::string>
+   {
+      const std::string_view name = args[i];
+      if (i + 1 >= args.size())
+      {
+         return std::unexpected("missing value for " + std::string(name));
+      }
+
+      return args[++i];
+   }
+
+   /**
+    * Parses the comma separated list following the option at `args[i]`, each item with `parse`
+    * returning an empty optional for an invalid item, and moves `i` past it.
+    */
+   template <typename T, typename Parse>
+   auto next_list(std::span<char*> args, std::size_t& i, Parse parse)
+      -> std::expected<std::vector<T>, std::string>
+   {
+      const std::string_view name = args[i];
+      const auto text = next_string(args, i);
+      if (not text)
+      {
+         return std::unexpected(text.error());
+      }
+
+      std::vector<T> items;
+      for (std::string_view rest = *text; not rest.empty();)
+      {
+         const auto comma = rest.find(',');
+         const std::string_view item = rest.substr(0, comma);
+         rest = comma == std::string_view::npos ? std::string_view() : rest.substr(comma + 1);
+
+         const std::optional<T> value = parse(item);
+         if (not value)
+         {
+            return std::unexpected("invalid value '" + std::string(item) + "' for " +
+                                   std::string(name));
+         }
+
+         items.push_back(*value);
+      }
+
+      if (items.empty())
+      {
+         return std::unexpected("missing value for " + std::string(name));
+      }
+
+      return items;
+   }
+
+   // The item of `all` called `name` by `to_name`.
+   template <typename T, std::size_t N, typename ToName>
+   auto find_named(const std::array<T, N>& all, std::string_view name, ToName to_name)
+      -> std::optional<T>
+   {
+      for (const T item : all)
+      {
+         if (to_name(item) == name)
+         {
+            return item;
+         }
+      }
+
+      return std::nullopt;
+   }
+} // namespace
+
+auto key_type_name(key_type type) -> std::string_view
+{
+   switch (type)
+   {
+      case key_type::int32:
+         return "i32";
+      case key_type::int64:
+         return "i64";
+      case key_type::float64:
+         return "f64";
+   }
+
+   return "unknown";
+}
+
+auto algorithm_name(benchmark_algorithm algorithm) -> std::string_view
+{
+   switch (algorithm)
+   {
+      case benchmark_algorithm::introsort:
+         return "introsort";
+      case benchmark_algorithm::std_sort:
+         return "std-sort";
+      case benchmark_algorithm::std_sort_par_unseq:
+         return "std-sort-par-unseq";
+      case benchmark_algorithm::parallel_introsort:
+         return "parallel-introsort";
+      case benchmark_algorithm::integer_sort:
+         return "integer-sort";
+      case benchmark_algorithm::hyperquicksort:
+         return "hyperquicksort";
+      case benchmark_algorithm::merging_hyperquicksort:
+         return "hyperquicksort-merge";
+      case benchmark_algorithm::sample_sort:
+         return "psrs";
+      case benchmark_algorithm::histogram_sort:
+         return "histogram";
+   }
+
+   return "unknown";
+}
+
+auto is_distributed(benchmark_algorithm algorithm) -> bool
+{
+   return algorithm == benchmark_algorithm::hyperquicksort or
+          algorithm == benchmark_algorithm::merging_hyperquicksort or
+          algorithm == benchmark_algorithm::sample_sort or
+          algorithm == benchmark_algorithm::histogram_sort;
+}
+
+auto parse_benchmark_options(std::span<char*> args)
+   -> std::expected<benchmark_options, std::string>
+{
+   benchmark_options result;
+
+   for (std::size_t i = 1; i < args.size(); ++i)
+   {
+      const std::string_view arg = args[i];
+
+      if (arg == "--sizes")
+      {
+         const auto sizes = next_list<u64>(args, i, [](std::string_view item) {
+            const auto size = parse_number<u64>("--sizes", item);
+            return size and *size > 0 ? std::optional(*size) : std::nullopt;
+         });
+         if (not sizes)
+         {
+            return std::unexpected(sizes.error());
+         }
+
+         result.sizes = *sizes;
+      }
+      else if (arg == "--distributions")
+      {
+         const auto distributions = next_list<distribution>(args, i, parse_distribution);
+         if (not distributions)
+         {
+            return std::unexpected(distributions.error());
+         }
+
+         result.distributions = *distributions;
+      }
+      else if (arg == "--types")
+      {
+         const auto types = next_list<key_type>(args, i, [](std::string_view item) {
+            return find_named(all_key_types, item, key_type_name);
+         });
+         if (not types)
+         {
+            return std::unexpected(types.error());
+         }
+
+         result.key_types = *types;
+      }
+      else if (arg == "--algorithms")
+      {
+         const auto algorithms = next_list<benchmark_algorithm>(args, i, [](std::string_view item) {
+            return find_named(all_benchmark_algorithms, item, algorithm_name);
+         });
+         if (not algorithms)
+         {
+            return std::unexpected(algorithms.error());
+         }
+
+         result.algorithms = *algorithms;
+      }
+      else if (arg == "--repetitions")
+      {
+         const auto text = next_string(args, i);
+         if (not text)
+         {
+            return std::unexpected(text.error());
+         }
+
+         const auto repetitions = parse_number<u32>(arg, *text);
+         if (not repetitions or *repetitions == 0)
+         {
+            return std::unexpected("--repetitions must be a positive number");
+         }
+
+         result.repetitions = *repetitions;
+      }
+      else if (arg == "--threads")
+      {
+         const auto text = next_string(args, i);
+         if (not text)
+         {
+            return std::unexpected(text.error());
+         }
+
+         const auto thread_count = parse_number<u32>(arg, *text);
+         if (not thread_count)
+         {
+            return std::unexpected(thread_count.error());
+         }
+
+         result.thread_count = *thread_count;
+      }
+      else if (arg == "--seed")
+      {
+         const auto text = next_string(args, i);
+         if (not text)
+         {
+            return std::unexpected(text.error());
+         }
+
+         const auto seed = parse_number<u64>(arg, *text);
+         if (not seed)
+         {
+            return std::unexpected(seed.error());
+         }
+
+         result.seed = *seed;
+      }
+      else
+      {
+         return std::unexpected("unknown option " + std::string(arg));
+      }
+   }
+
+   return result;
+}
@@ -0,0 +1,75 @@
+#ifndef PARALLEL_QSORT_BENCHMARK_BENCHMARK_OPTIONS_HPP_
+#define PARALLEL_QSORT_BENCHMARK_BENCHMARK_OPTIONS_HPP_
+
+#include <parallel-qsort/benchmark/input.hpp>
+#include <parallel-qsort/types.hpp>
+
+#include <array>
+#include <expected>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+enum class key_type
+{
+   int32,
+   int64,
+   float64
+};
+
+inline constexpr std::array all_key_types = {key_type::int32, key_type::int64, key_type::float64};
+
+auto key_type_name(key_type type) -> std::string_view;
+
+enum class benchmark_algorithm
+{
+   // On rank 0 alone.
+   introsort,          // the project's introsort, sequential
+   std_sort,           // std::sort
+   std_sort_par_unseq, // std::sort(std::execution::par_unseq, ...)
+   parallel_introsort, // introsort on the work stealing pool
+   integer_sort,       // counting or LSD radix sort, integer keys only
+
+   // Across every rank.
+   hyperquicksort,         // i32 keys and a power of two ranks only
+   merging_hyperquicksort, // i32 keys and a power of two ranks only
+   sample_sort,
+   histogram_sort // i32 keys only
+};
+
+inline constexpr std::array all_benchmark_algorithms = {
+   benchmark_algorithm::introsort,          benchmark_algorithm::std_sort,
+   benchmark_algorithm::std_sort_par_unseq, benchmark_algorithm::parallel_introsort,
+   benchmark_algorithm::integer_sort,       benchmark_algorithm::hyperquicksort,
+   benchmark_algorithm::merging_hyperquicksort, benchmark_algorithm::sample_sort,
+   benchmark_algorithm::histogram_sort};
+
+auto algorithm_name(benchmark_algorithm algorithm) -> std::string_view;
+
+// Whether `algorithm` sorts the elements of every rank rather than an array on rank 0.
+auto is_distributed(benchmark_algorithm algorithm) -> bool;
+
+struct benchmark_options
+{
+   // Total elements of an input, on rank 0 for the local sorts and over the ranks otherwise.
+   std::vector<u64> sizes = {1'000, 10'000, 100'000, 1'000'000, 10'000'000};
+
+   std::vector<distribution> distributions = {begin(all_distributions), end(all_distributions)};
+   std::vector<key_type> key_types = {begin(all_key_types), end(all_key_types)};
+   std::vector<benchmark_algorithm> algorithms = {begin(all_benchmark_algorithms),
+                                                  end(all_benchmark_algorithms)};
+
+   // Runs of every measurement, of which the fastest is reported.
+   u32 repetitions = 3;
+
+   // Threads of the work stealing pool of every rank, 0 starts one per CPU available to the rank.
+   u32 thread_count = 0;
+
+   u64 seed = 1;
+};
+
+auto parse_benchmark_options(std::span<char*> args)
+   -> std::expected<benchmark_options, std::string>;
+
+#endif // PARALLEL_QSORT_BENCHMARK_BENCHMARK_OPTIONS_HPP_
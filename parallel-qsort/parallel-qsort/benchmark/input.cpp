@@ -0,0 +1,62 @@
+#include <parallel-qsort/benchmark/input.hpp>
+
+#include <cmath>
+#include <vector>
+
+auto distribution_name(distribution kind) -> std::string_view
+{
+   switch (kind)
+   {
+      case distribution::uniform:
+         return "uniform";
+      case distribution::sorted:
+         return "sorted";
+      case distribution::reverse:
+         return "reverse";
+      case distribution::organ_pipe:
+         return "organ-pipe";
+      case distribution::few_unique:
+         return "few-unique";
+      case distribution::zipf:
+         return "zipf";
+      case distribution::all_equal:
+         return "all-equal";
+   }
+
+   return "unknown";
+}
+
+auto parse_distribution(std::string_view name) -> std::optional<distribution>
+{
+   for (const distribution kind : all_distributions)
+   {
+      if (distribution_name(kind) == name)
+      {
+         return kind;
+      }
+   }
+
+   return std::nullopt;
+}
+
+auto zipf_cdf() -> std::span<const f64>
+{
+   static const std::vector<f64> cdf = [] {
+      auto weights = std::vector<f64>(zipf_universe);
+
+      f64 total = 0.0;
+      for (u64 k = 0; k < zipf_universe; ++k)
+      {
+         total += 1.0 / static_cast<f64>(k + 1);
+         weights[k] = total;
+      }
+      for (auto& weight : weights)
+      {
+         weight /= total;
+      }
+
+      return weights;
+   }();
+
+   return cdf;
+}
@@ -0,0 +1,109 @@
+#ifndef PARALLEL_QSORT_BENCHMARK_INPUT_HPP_
+#define PARALLEL_QSORT_BENCHMARK_INPUT_HPP_
+
+#include <parallel-qsort/types.hpp>
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <limits>
+#include <optional>
+#include <random>
+#include <span>
+#include <string_view>
+
+enum class distribution
+{
+   uniform,    // the whole range of the key type, [-1, 1) for floating point
+   sorted,     // 0, 1, 2, ...
+   reverse,    // n - 1, n - 2, ..., 0
+   organ_pipe, // ascending to the middle, then descending
+   few_unique, // `few_unique_count` distinct keys
+   zipf,       // `zipf_universe` distinct keys, the k-th most frequent drawn with weight 1 / k
+   all_equal   // a single key
+};
+
+inline constexpr std::array all_distributions = {
+   distribution::uniform,    distribution::sorted, distribution::reverse,
+   distribution::organ_pipe, distribution::few_unique, distribution::zipf,
+   distribution::all_equal};
+
+inline constexpr u64 few_unique_count = 16;
+inline constexpr u64 zipf_universe = u64{1} << 16;
+
+auto distribution_name(distribution kind) -> std::string_view;
+auto parse_distribution(std::string_view name) -> std::optional<distribution>;
+
+// The cumulative distribution of the zipf keys 1 to `zipf_universe`.
+auto zipf_cdf() -> std::span<const f64>;
+
+/**
+ * Fills `out` with the elements at positions [first, first + out.size()) of an input of `total`
+ * elements following `kind`. The ordered distributions depend on the position only, so that the
+ * slices of every rank make up one global input, the random ones draw from `engine`.
+ */
+template <typename T>
+void generate_input(distribution kind, std::span<T> out, u64 first, u64 total,
+                    std::mt19937_64& engine)
+{
+   switch (kind)
+   {
+      case distribution::uniform:
+         if constexpr (std::integral<T>)
+         {
+            auto keys = std::uniform_int_distribution<T>(std::numeric_limits<T>::lowest(),
+                                                         std::numeric_limits<T>::max());
+            std::ranges::generate(out, [&] {
+               return keys(engine);
+            });
+         }
+         else
+         {
+            auto keys = std::uniform_real_distribution<T>(-1, 1);
+            std::ranges::generate(out, [&] {
+               return keys(engine);
+            });
+         }
+         break;
+      case distribution::sorted:
+         for (std::size_t i = 0; i < out.size(); ++i)
+         {
+            out[i] = static_cast<T>(first + i);
+         }
+         break;
+      case distribution::reverse:
+         for (std::size_t i = 0; i < out.size(); ++i)
+         {
+            out[i] = static_cast<T>(total - 1 - (first + i));
+         }
+         break;
+      case distribution::organ_pipe:
+         for (std::size_t i = 0; i < out.size(); ++i)
+         {
+            out[i] = static_cast<T>(std::min(first + i, total - 1 - (first + i)));
+         }
+         break;
+      case distribution::few_unique:
+      {
+         auto keys = std::uniform_int_distribution<u64>(0, few_unique_count - 1);
+         std::ranges::generate(out, [&] {
+            return static_cast<T>(keys(engine));
+         });
+         break;
+      }
+      case distribution::zipf:
+      {
+         const auto cdf = zipf_cdf();
+         auto draws = std::uniform_real_distribution<f64>(0, 1);
+         std::ranges::generate(out, [&] {
+            return static_cast<T>(std::ranges::lower_bound(cdf, draws(engine)) - begin(cdf) + 1);
+         });
+         break;
+      }
+      case distribution::all_equal:
+         std::ranges::fill(out, static_cast<T>(42));
+         break;
+   }
+}
+
+#endif // PARALLEL_QSORT_BENCHMARK_INPUT_HPP_
@@ -0,0 +1,408 @@
+#include <parallel-qsort/benchmark/benchmark_options.hpp>
+#include <parallel-qsort/benchmark/input.hpp>
+#include <parallel-qsort/benchmark/verify.hpp>
+#include <parallel-qsort/histogram_sort.hpp>
+#include <parallel-qsort/hyperquicksort.hpp>
+#include <parallel-qsort/sample_sort.hpp>
+#include <parallel-qsort/seeding.hpp>
+#include <parallel-qsort/trace.hpp>
+#include <parallel-qsort/types.hpp>
+
+#include <libqsort/integer_sort.hpp>
+#include <libqsort/introsort.hpp>
+#include <libqsort/parallel_introsort.hpp>
+#include <libqsort/work_stealing_pool.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <concepts>
+#include <cstdlib>
+#include <execution>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include <mpi.h>
+
+namespace
+{
+   struct measurement
+   {
+      f64 seconds = std::numeric_limits<f64>::infinity(); // fastest run, on the slowest rank
+      std::optional<u64> comparisons;     // counted by the sequential comparison sorts
+      std::optional<u64> bytes_exchanged; // sent between ranks, summed over the ranks
+      bool sorted = false;                // sorted, and a permutation of the input
+   };
+
+   struct counting_less
+   {
+      u64* count;
+
+      template <typename T>
+      auto operator()(const T& lhs, const T& rhs) const noexcept -> bool
+      {
+         ++*count;
+         return lhs < rhs;
+      }
+   };
+
+   // An MPI_Barrier that sleeps rather than spins, leaving the CPUs to the threads of rank 0
+   // while it runs the local sorts.
+   void idle_barrier(MPI_Comm communicator)
+   {
+      MPI_Request request = MPI_REQUEST_NULL;
+      MPI_Ibarrier(communicator, &request);
+
+      int done = 0;
+      MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+      while (done == 0)
+      {
+         std::this_thread::sleep_for(std::chrono::milliseconds(1));
+         MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+      }
+   }
+
+   template <typename T>
+   auto applies(benchmark_algorithm algorithm, int process_count) -> bool
+   {
+      switch (algorithm)
+      {
+         case benchmark_algorithm::integer_sort:
+            return std::integral<T>;
+         case benchmark_algorithm::hyperquicksort:
+         case benchmark_algorithm::merging_hyperquicksort:
+            return std::same_as<T, i32> and std::has_single_bit(static_cast<u32>(process_count));
+         case benchmark_algorithm::histogram_sort:
+            return std::same_as<T, i32>;
+         default:
+            return true;
+      }
+   }
+
+   template <typename T>
+   void sort_locally(benchmark_algorithm algorithm, std::vector<T>& values,
+                     work_stealing_pool& pool)
+   {
+      switch (algorithm)
+      {
+         case benchmark_algorithm::introsort:
+            introsort(begin(values), end(values));
+            break;
+         case benchmark_algorithm::std_sort:
+            std::sort(begin(values), end(values));
+            break;
+         case benchmark_algorithm::std_sort_par_unseq:
+            std::sort(std::execution::par_unseq, begin(values), end(values));
+            break;
+         case benchmark_algorithm::parallel_introsort:
+            parallel_introsort(pool, begin(values), end(values));
+            break;
+         case benchmark_algorithm::integer_sort:
+            if constexpr (std::integral<T>)
+            {
+               integer_sort(begin(values), end(values));
+            }
+            break;
+         default:
+            break;
+      }
+   }
+
+   template <typename T>
+   void sort_distributed(benchmark_algorithm algorithm, std::vector<T>& local_array,
+                         std::mt19937_64& sample_engine, work_stealing_pool& pool)
+   {
+      switch (algorithm)
+      {
+         case benchmark_algorithm::hyperquicksort:
+            if constexpr (std::same_as<T, i32>)
+            {
+               hyperquicksort(local_array, pivot_rule::sample_median, sample_engine, pool,
+                              MPI_COMM_WORLD);
+            }
+            break;
+         case benchmark_algorithm::merging_hyperquicksort:
+            if constexpr (std::same_as<T, i32>)
+            {
+               merging_hyperquicksort(local_array, pivot_rule::sample_median, sample_engine, pool,
+                                      MPI_COMM_WORLD);
+            }
+            break;
+         case benchmark_algorithm::sample_sort:
+            sample_sort(local_array, pool, MPI_COMM_WORLD);
+            break;
+         case benchmark_algorithm::histogram_sort:
+            if constexpr (std::same_as<T, i32>)
+            {
+               histogram_sort(local_array, pool, MPI_COMM_WORLD);
+            }
+            break;
+         default:
+            break;
+      }
+   }
+
+   // Sorts copies of `input` on this rank alone, counting the comparisons of the sequential
+   // comparison sorts in one more run so that the counter does not slow down the timed ones.
+   template <typename T>
+   auto measure_local(benchmark_algorithm algorithm, const std::vector<T>& input,
+                      u32 repetitions, work_stealing_pool& pool) -> measurement
+   {
+      measurement result;
+
+      std::vector<T> values;
+      for (u32 run = 0; run < repetitions; ++run)
+      {
+         values = input;
+
+         const auto start = std::chrono::steady_clock::now();
+         sort_locally(algorithm, values, pool);
+         const std::chrono::duration<f64> elapsed = std::chrono::steady_clock::now() - start;
+
+         result.seconds = std::min(result.seconds, elapsed.count());
+      }
+
+      result.sorted = std::ranges::is_sorted(values) and
+                      input_digest<T>(values) == input_digest<T>(input);
+
+      if (algorithm == benchmark_algorithm::introsort or
+          algorithm == benchmark_algorithm::std_sort)
+      {
+         u64 count = 0;
+         values = input;
+         if (algorithm == benchmark_algorithm::introsort)
+         {
+            introsort(begin(values), end(values), counting_less{&count});
+         }
+         else
+         {
+            std::sort(begin(values), end(values), counting_less{&count});
+         }
+
+         result.comparisons = count;
+      }
+
+      return result;
+   }
+
+   // Sorts copies of the local arrays `input` over every rank. Collective.
+   template <typename T>
+   auto measure_distributed(benchmark_algorithm algorithm, const std::vector<T>& input,
+                            u32 repetitions, u64 seed, work_stealing_pool& pool) -> measurement
+   {
+      int process_id = 0;
+      MPI_Comm_rank(MPI_COMM_WORLD, &process_id);
+
+      measurement result;
+
+      std::vector<T> local_array;
+      u64 bytes = 0;
+      for (u32 run = 0; run < repetitions; ++run)
+      {
+         local_array = input;
+
+         auto sample_engine = seeded_engine<std::mt19937_64>(
+            {seed, static_cast<u64>(process_id), static_cast<u64>(run)});
+
+         const u64 bytes_before = rank_trace().bytes(phase::exchange);
+
+         MPI_Barrier(MPI_COMM_WORLD);
+         const f64 start = MPI_Wtime();
+
+         sort_distributed(algorithm, local_array, sample_engine, pool);
+
+         f64 elapsed = MPI_Wtime() - start;
+         MPI_Allreduce(MPI_IN_PLACE, &elapsed, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+         result.seconds = std::min(result.seconds, elapsed);
+         bytes = rank_trace().bytes(phase::exchange) - bytes_before;
+      }
+
+      MPI_Allreduce(MPI_IN_PLACE, &bytes, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+      result.bytes_exchanged = bytes;
+
+      const bool sorted = globally_sorted<T>(local_array, MPI_COMM_WORLD);
+      result.sorted = sorted and global_digest<T>(local_array, MPI_COMM_WORLD) ==
+                                    global_digest<T>(input, MPI_COMM_WORLD);
+
+      return result;
+   }
+
+   void print_header()
+   {
+      std::cout << std::left << std::setw(5) << "type" << std::setw(12) << "distribution"
+                << std::right << std::setw(12) << "elements" << "  " << std::left
+                << std::setw(22) << "algorithm" << std::right << std::setw(6) << "ranks"
+                << std::setw(12) << "seconds" << std::setw(14) << "elements/s" << std::setw(14)
+                << "comparisons" << std::setw(14) << "bytes" << std::setw(8) << "sorted"
+                << '\n';
+   }
+
+   void print_row(key_type type, distribution kind, u64 size, benchmark_algorithm algorithm,
+                  int ranks, const measurement& result)
+   {
+      const auto optional_count = [](std::optional<u64> count) {
+         return count ? std::to_string(*count) : std::string("-");
+      };
+
+      const auto flags = std::cout.flags();
+      const auto precision = std::cout.precision();
+
+      std::cout << std::left << std::setw(5) << key_type_name(type) << std::setw(12)
+                << distribution_name(kind) << std::right << std::setw(12) << size << "  "
+                << std::left << std::setw(22) << algorithm_name(algorithm) << std::right
+                << std::setw(6) << ranks << std::fixed << std::setprecision(6) << std::setw(12)
+                << result.seconds << std::setprecision(0) << std::setw(14)
+                << static_cast<f64>(size) / result.seconds << std::setw(14)
+                << optional_count(result.comparisons) << std::setw(14)
+                << optional_count(result.bytes_exchanged) << std::setw(8)
+                << (result.sorted ? "yes" : "NO") << '\n';
+
+      std::cout.flags(flags);
+      std::cout.precision(precision);
+   }
+
+   /**
+    * Measures every selected algorithm that applies to keys of type `T` over every selected
+    * distribution and size, the local sorts on an input generated on rank 0 while the other ranks
+    * wait, then the distributed ones on slices of the same distribution generated by every rank.
+    * Returns whether every output was verified. Collective.
+    */
+   template <typename T>
+   auto run_benchmarks(const benchmark_options& opts, key_type type, work_stealing_pool& pool)
+      -> bool
+   {
+      int process_id = 0;
+      int process_count = 0;
+      MPI_Comm_rank(MPI_COMM_WORLD, &process_id);
+      MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+
+      bool all_sorted = true;
+
+      for (const distribution kind : opts.distributions)
+      {
+         for (const u64 size : opts.sizes)
+         {
+            if (process_id == 0)
+            {
+               auto input_engine = seeded_engine<std::mt19937_64>({opts.seed, u64{0}});
+
+               std::vector<T> input;
+               for (const benchmark_algorithm algorithm : opts.algorithms)
+               {
+                  if (is_distributed(algorithm) or not applies<T>(algorithm, process_count))
+                  {
+                     continue;
+                  }
+
+                  if (input.empty())
+                  {
+                     input.resize(size);
+                     generate_input<T>(kind, input, 0, size, input_engine);
+                  }
+
+                  const auto result = measure_local(algorithm, input, opts.repetitions, pool);
+                  print_row(type, kind, size, algorithm, 1, result);
+
+                  all_sorted = all_sorted and result.sorted;
+               }
+            }
+
+            idle_barrier(MPI_COMM_WORLD);
+
+            // The first `size % process_count` ranks take one extra element.
+            const u64 rank = static_cast<u64>(process_id);
+            const u64 ranks = static_cast<u64>(process_count);
+            const u64 first = size / ranks * rank + std::min(rank, size % ranks);
+
+            auto input_engine = seeded_engine<std::mt19937_64>({opts.seed, rank});
+
+            std::vector<T> input;
+            for (const benchmark_algorithm algorithm : opts.algorithms)
+            {
+               if (not is_distributed(algorithm) or not applies<T>(algorithm, process_count))
+               {
+                  continue;
+               }
+
+               if (input.empty())
+               {
+                  input.resize(size / ranks + (rank < size % ranks ? 1 : 0));
+                  generate_input<T>(kind, input, first, size, input_engine);
+               }
+
+               const auto result =
+                  measure_distributed(algorithm, input, opts.repetitions, opts.seed, pool);
+               if (process_id == 0)
+               {
+                  print_row(type, kind, size, algorithm, process_count, result);
+               }
+
+               all_sorted = all_sorted and result.sorted;
+            }
+         }
+      }
+
+      return all_sorted;
+   }
+} // namespace
+
+auto main(int argc, char* argv[]) -> int
+{
+   int process_id = 0;
+   int process_count = 0;
+
+   MPI_Init(&argc, &argv);
+
+   MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+   MPI_Comm_rank(MPI_COMM_WORLD, &process_id);
+
+   const auto opts = parse_benchmark_options({argv, static_cast<std::size_t>(argc)});
+   if (not opts)
+   {
+      if (process_id == 0)
+      {
+         std::cout << "error: " << opts.error() << '\n';
+      }
+
+      MPI_Finalize();
+
+      return EXIT_FAILURE;
+   }
+
+   auto pool = work_stealing_pool(opts->thread_count == 0 ? available_cpu_count()
+                                                          : opts->thread_count);
+
+   if (process_id == 0)
+   {
+      std::cout << "ranks: " << process_count << ", threads per rank: " << pool.size()
+                << ", best of " << opts->repetitions << " runs\n";
+      print_header();
+   }
+
+   bool all_sorted = true;
+   for (const key_type type : opts->key_types)
+   {
+      switch (type)
+      {
+         case key_type::int32:
+            all_sorted = run_benchmarks<i32>(*opts, type, pool) and all_sorted;
+            break;
+         case key_type::int64:
+            all_sorted = run_benchmarks<i64>(*opts, type, pool) and all_sorted;
+            break;
+         case key_type::float64:
+            all_sorted = run_benchmarks<f64>(*opts, type, pool) and all_sorted;
+            break;
+      }
+   }
+
+   MPI_Finalize();
+
+   return all_sorted ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,91 @@
+#ifndef PARALLEL_QSORT_BENCHMARK_VERIFY_HPP_
+#define PARALLEL_QSORT_BENCHMARK_VERIFY_HPP_
+
+#include <parallel-qsort/mpi_type.hpp>
+#include <parallel-qsort/types.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <span>
+
+#include <mpi.h>
+
+namespace detail
+{
+   // The splitmix64 finalizer, so that a sum of keys tells permutations from other changes.
+   constexpr auto mix(u64 value) noexcept -> u64
+   {
+      value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+      value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+
+      return value ^ (value >> 31);
+   }
+
+   template <typename T>
+   auto key_bits(const T& value) noexcept -> u64
+   {
+      static_assert(sizeof(T) <= sizeof(u64));
+
+      u64 bits = 0;
+      std::memcpy(&bits, &value, sizeof(T));
+
+      return bits;
+   }
+} // namespace detail
+
+// {element count, sum of mixed keys}, equal for an input and any permutation of it.
+using digest = std::array<u64, 2>;
+
+template <typename T>
+auto input_digest(std::span<const T> values) -> digest
+{
+   digest result = {values.size(), 0};
+   for (const T& value : values)
+   {
+      result[1] += detail::mix(detail::key_bits(value));
+   }
+
+   return result;
+}
+
+// input_digest() of the elements of every rank of `communicator`. Collective.
+template <typename T>
+auto global_digest(std::span<const T> values, MPI_Comm communicator) -> digest
+{
+   auto result = input_digest(values);
+   MPI_Allreduce(MPI_IN_PLACE, result.data(), 2, MPI_UINT64_T, MPI_SUM, communicator);
+
+   return result;
+}
+
+/**
+ * Whether the local arrays are sorted and every key of a rank is at most the smallest key of the
+ * ranks after it. Collective.
+ */
+template <typename T>
+auto globally_sorted(std::span<const T> values, MPI_Comm communicator) -> bool
+{
+   int process_id = 0;
+   MPI_Comm_rank(communicator, &process_id);
+
+   bool sorted = std::ranges::is_sorted(values);
+
+   // The largest key of the ranks before this one.
+   T last = values.empty() ? std::numeric_limits<T>::lowest() : values.back();
+   T previous = std::numeric_limits<T>::lowest();
+   MPI_Exscan(&last, &previous, 1, mpi_datatype<T>(), MPI_MAX, communicator);
+   if (process_id != 0 and not values.empty())
+   {
+      sorted = sorted and not (values.front() < previous);
+   }
+
+   int all_sorted = sorted ? 1 : 0;
+   MPI_Allreduce(MPI_IN_PLACE, &all_sorted, 1, MPI_INT, MPI_LAND, communicator);
+
+   return all_sorted == 1;
+}
+
+#endif // PARALLEL_QSORT_BENCHMARK_VERIFY_HPP_
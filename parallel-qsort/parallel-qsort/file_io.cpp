@@ -0,0 +1,167 @@
+#include <parallel-qsort/file_io.hpp>
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <limits>
+
+namespace
+{
+   // Largest block handed to one MPI-IO call, whose counts are ints.
+   constexpr u64 io_block_bytes = u64{1} << 30;
+
+   // Longest key in the text format, "-2147483648" and its newline.
+   constexpr std::size_t max_text_key_size = std::numeric_limits<i32>::digits10 + 3;
+
+   auto error_string(int code) -> std::string
+   {
+      std::array<char, MPI_MAX_ERROR_STRING> text = {};
+      int length = 0;
+      MPI_Error_string(code, text.data(), &length);
+
+      return {text.data(), static_cast<std::size_t>(length)};
+   }
+
+   /**
+    * Moves `size` bytes at `offset` through `transfer`, a collective MPI-IO call, in blocks of at
+    * most `io_block_bytes`. Every rank makes as many calls as the rank with the most bytes, the
+    * ones done early with empty blocks, and the ranks agree on the result.
+    */
+   template <typename Byte, typename Transfer>
+   auto blocked_transfer(MPI_File file, MPI_Offset offset, Byte* data, u64 size,
+                         Transfer transfer, MPI_Comm communicator) -> int
+   {
+      u64 block_count = (size + io_block_bytes - 1) / io_block_bytes;
+      MPI_Allreduce(MPI_IN_PLACE, &block_count, 1, MPI_UINT64_T, MPI_MAX, communicator);
+
+      int status = MPI_SUCCESS;
+      for (u64 block = 0; block < block_count; ++block)
+      {
+         const u64 first = std::min(size, block * io_block_bytes);
+         const u64 count = std::min(size - first, io_block_bytes);
+
+         const int result = transfer(file, offset + static_cast<MPI_Offset>(first), data + first,
+                                     static_cast<int>(count), MPI_BYTE, MPI_STATUS_IGNORE);
+         if (result != MPI_SUCCESS)
+         {
+            status = result;
+         }
+      }
+
+      MPI_Allreduce(MPI_IN_PLACE, &status, 1, MPI_INT, MPI_MAX, communicator);
+
+      return status;
+   }
+
+   auto format_text(std::span<const i32> values) -> std::vector<char>
+   {
+      auto text = std::vector<char>(values.size() * max_text_key_size);
+
+      char* out = text.data();
+      for (const i32 value : values)
+      {
+         out = std::to_chars(out, text.data() + text.size(), value).ptr;
+         *out++ = '\n';
+      }
+
+      text.resize(static_cast<std::size_t>(out - text.data()));
+
+      return text;
+   }
+} // namespace
+
+auto read_partition(const std::filesystem::path& path, MPI_Comm communicator)
+   -> std::expected<std::vector<i32>, std::string>
+{
+   int process_id = 0;
+   int process_count = 0;
+   MPI_Comm_rank(communicator, &process_id);
+   MPI_Comm_size(communicator, &process_count);
+
+   MPI_File file = MPI_FILE_NULL;
+   const int opened =
+      MPI_File_open(communicator, path.c_str(), MPI_MODE_RDONLY, MPI_INFO_NULL, &file);
+   if (opened != MPI_SUCCESS)
+   {
+      return std::unexpected("cannot open " + path.string() + ": " + error_string(opened));
+   }
+
+   MPI_Offset file_size = 0;
+   MPI_File_get_size(file, &file_size);
+   if (file_size % static_cast<MPI_Offset>(sizeof(i32)) != 0)
+   {
+      MPI_File_close(&file);
+
+      return std::unexpected(path.string() + " is not a whole number of 32-bit keys");
+   }
+
+   // The first `count % process_count` ranks take one extra element.
+   const u64 count = static_cast<u64>(file_size) / sizeof(i32);
+   const u64 rank = static_cast<u64>(process_id);
+   const u64 ranks = static_cast<u64>(process_count);
+   const u64 first = count / ranks * rank + std::min(rank, count % ranks);
+   const u64 size = count / ranks + (rank < count % ranks ? 1 : 0);
+
+   auto local_array = std::vector<i32>(size);
+   const int status = blocked_transfer(
+      file, static_cast<MPI_Offset>(first * sizeof(i32)),
+      reinterpret_cast<char*>(local_array.data()), size * sizeof(i32), MPI_File_read_at_all,
+      communicator);
+
+   MPI_File_close(&file);
+
+   if (status != MPI_SUCCESS)
+   {
+      return std::unexpected("cannot read " + path.string() + ": " + error_string(status));
+   }
+
+   return local_array;
+}
+
+auto write_partition(const std::filesystem::path& path, std::span<const i32> local_array,
+                     output_format format, MPI_Comm communicator)
+   -> std::expected<void, std::string>
+{
+   int process_id = 0;
+   MPI_Comm_rank(communicator, &process_id);
+
+   std::vector<char> text;
+   std::span<const char> bytes = {reinterpret_cast<const char*>(local_array.data()),
+                                  local_array.size_bytes()};
+   if (format == output_format::text)
+   {
+      text = format_text(local_array);
+      bytes = text;
+   }
+
+   u64 size = bytes.size();
+   u64 offset = 0;
+   MPI_Exscan(&size, &offset, 1, MPI_UINT64_T, MPI_SUM, communicator);
+   if (process_id == 0)
+   {
+      offset = 0;
+   }
+
+   MPI_File file = MPI_FILE_NULL;
+   const int opened = MPI_File_open(communicator, path.c_str(), MPI_MODE_CREATE | MPI_MODE_WRONLY,
+                                    MPI_INFO_NULL, &file);
+   if (opened != MPI_SUCCESS)
+   {
+      return std::unexpected("cannot open " + path.string() + ": " + error_string(opened));
+   }
+
+   // Drops whatever a longer previous file left past the end.
+   MPI_File_set_size(file, 0);
+
+   const int status = blocked_transfer(file, static_cast<MPI_Offset>(offset), bytes.data(), size,
+                                       MPI_File_write_at_all, communicator);
+
+   MPI_File_close(&file);
+
+   if (status != MPI_SUCCESS)
+   {
+      return std::unexpected("cannot write " + path.string() + ": " + error_string(status));
+   }
+
+   return {};
+}
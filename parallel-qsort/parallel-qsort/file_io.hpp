@@ -0,0 +1,38 @@
+#ifndef PARALLEL_QSORT_FILE_IO_HPP_
+#define PARALLEL_QSORT_FILE_IO_HPP_
+
+#include <parallel-qsort/types.hpp>
+
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <mpi.h>
+
+enum class output_format
+{
+   binary, // native i32, the layout of the input
+   text    // one decimal key per line
+};
+
+/**
+ * Reads this rank's slice of a binary file of native i32 with a collective MPI-IO read, rank r
+ * taking the r-th of p slices whose sizes differ by at most one element. No rank ever holds more
+ * than its own slice. Collective over `communicator`.
+ */
+auto read_partition(const std::filesystem::path& path, MPI_Comm communicator)
+   -> std::expected<std::vector<i32>, std::string>;
+
+/**
+ * Writes the local arrays of the ranks of `communicator` one after the other into `path`, each
+ * rank at the offset given by an exclusive prefix sum of the sizes before it, with a collective
+ * MPI-IO write. The text format is rendered with std::to_chars into a buffer per rank, so that its
+ * offsets are byte counts rather than element counts. Collective over `communicator`.
+ */
+auto write_partition(const std::filesystem::path& path, std::span<const i32> local_array,
+                     output_format format, MPI_Comm communicator)
+   -> std::expected<void, std::string>;
+
+#endif // PARALLEL_QSORT_FILE_IO_HPP_
@@ -0,0 +1,160 @@
+#include <parallel-qsort/histogram_sort.hpp>
+
+#include <parallel-qsort/log.hpp>
+#include <parallel-qsort/pivot.hpp>
+#include <parallel-qsort/sample_sort.hpp>
+#include <parallel-qsort/trace.hpp>
+
+#include <libqsort/local_sort.hpp>
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <limits>
+#include <numeric>
+
+void histogram_sort(std::vector<i32>& local_array, work_stealing_pool& pool,
+                    MPI_Comm communicator)
+{
+   int process_id = 0;
+   int process_count = 0;
+   MPI_Comm_rank(communicator, &process_id);
+   MPI_Comm_size(communicator, &process_count);
+
+   if (process_count == 1)
+   {
+      const scoped_phase timer(phase::local_sort);
+      local_sort(pool, begin(local_array), end(local_array));
+      return;
+   }
+
+   scoped_phase pivot_timer(phase::pivot);
+
+   // {-min, max}, so that a single maximum reduction gives both bounds.
+   std::array<i64, 2> bounds = {std::numeric_limits<i64>::min(),
+                                std::numeric_limits<i64>::min()};
+   if (not local_array.empty())
+   {
+      const auto [min, max] = std::ranges::minmax_element(local_array);
+      bounds = {-static_cast<i64>(*min), static_cast<i64>(*max)};
+   }
+   MPI_Allreduce(MPI_IN_PLACE, bounds.data(), 2, MPI_INT64_T, MPI_MAX, communicator);
+
+   if (bounds[1] == std::numeric_limits<i64>::min())
+   {
+      return;
+   }
+
+   const i64 lowest = -bounds[0];
+   const u64 bucket_count = static_cast<u64>(bounds[1] - lowest) + 1;
+   if (bucket_count > max_histogram_buckets)
+   {
+      pivot_timer.finish();
+      sample_sort(local_array, pool, communicator);
+      return;
+   }
+
+   pivot_timer.finish();
+
+   {
+      const scoped_phase timer(phase::local_sort);
+      local_sort(pool, begin(local_array), end(local_array));
+   }
+
+   // The global histogram plays the part of the splitters.
+   scoped_phase histogram_timer(phase::pivot);
+
+   auto counts = std::vector<u64>(bucket_count, 0);
+   for (const i32 value : local_array)
+   {
+      ++counts[value - lowest];
+   }
+
+   // The count of every key over the job, and over the ranks before this one.
+   auto totals = std::vector<u64>(bucket_count, 0);
+   auto before = std::vector<u64>(bucket_count, 0);
+   MPI_Allreduce(counts.data(), totals.data(), static_cast<int>(bucket_count), MPI_UINT64_T,
+                 MPI_SUM, communicator);
+   MPI_Exscan(counts.data(), before.data(), static_cast<int>(bucket_count), MPI_UINT64_T,
+              MPI_SUM, communicator);
+   if (process_id == 0)
+   {
+      std::ranges::fill(before, 0);
+   }
+
+   histogram_timer.finish();
+
+   scoped_phase partition_timer(phase::partition);
+
+   const u64 total = std::accumulate(begin(totals), end(totals), u64{0});
+
+   // Rank r owns the final positions [first_position[r], first_position[r + 1]).
+   auto first_position = std::vector<u64>(process_count + 1);
+   for (int r = 0; r <= process_count; ++r)
+   {
+      first_position[r] = total / process_count * r + std::min<u64>(r, total % process_count);
+   }
+
+   // The local elements of a key hold consecutive final positions, which only ever increase along
+   // the sorted local array, so every rank receives one contiguous slice of it.
+   auto send_counts = std::vector<int>(process_count, 0);
+
+   u64 key_position = 0;
+   int owner = 0;
+   for (u64 bucket = 0; bucket < bucket_count; ++bucket)
+   {
+      u64 position = key_position + before[bucket];
+      const u64 last = position + counts[bucket];
+
+      while (position < last)
+      {
+         while (first_position[owner + 1] <= position)
+         {
+            ++owner;
+         }
+
+         const u64 stop = std::min(last, first_position[owner + 1]);
+         send_counts[owner] += static_cast<int>(stop - position);
+         position = stop;
+      }
+
+      key_position += totals[bucket];
+   }
+
+   auto send_displacements = std::vector<int>(process_count, 0);
+   std::exclusive_scan(begin(send_counts), end(send_counts), begin(send_displacements), 0);
+
+   partition_timer.finish();
+
+   scoped_phase exchange_timer(phase::exchange);
+   exchange_timer.add_bytes((local_array.size() - send_counts[process_id]) * sizeof(i32));
+
+   auto receive_counts = std::vector<int>(process_count, 0);
+   MPI_Alltoall(send_counts.data(), 1, MPI_INT, receive_counts.data(), 1, MPI_INT, communicator);
+
+   auto receive_displacements = std::vector<int>(process_count, 0);
+   std::exclusive_scan(begin(receive_counts), end(receive_counts),
+                       begin(receive_displacements), 0);
+
+   auto received = std::vector<i32>(receive_displacements.back() + receive_counts.back());
+   MPI_Alltoallv(local_array.data(), send_counts.data(), send_displacements.data(), MPI_INT32_T,
+                 received.data(), receive_counts.data(), receive_displacements.data(),
+                 MPI_INT32_T, communicator);
+
+   exchange_timer.finish();
+
+   {
+      const scoped_phase timer(phase::local_sort);
+      local_sort(pool, begin(received), end(received));
+   }
+   local_array = std::move(received);
+
+   if constexpr (verbose_logging)
+   {
+      const f64 imbalance = load_imbalance(local_array.size(), communicator);
+      if (process_id == 0)
+      {
+         std::cout << "exchange - imbalance: " << imbalance << '\n';
+      }
+   }
+}
@@ -0,0 +1,28 @@
+#ifndef PARALLEL_QSORT_HISTOGRAM_SORT_HPP_
+#define PARALLEL_QSORT_HISTOGRAM_SORT_HPP_
+
+#include <parallel-qsort/types.hpp>
+
+#include <libqsort/work_stealing_pool.hpp>
+
+#include <vector>
+
+#include <mpi.h>
+
+// Widest key range sorted through a global histogram, one 64-bit count per key.
+inline constexpr u64 max_histogram_buckets = u64{1} << 20;
+
+/**
+ * Sorts the elements spread over the ranks of `communicator`, of any size, through a global
+ * histogram of their keys: the per-key counts of every rank are summed with an all-reduce, which
+ * gives every rank the final position of each of its elements, and a single all-to-all exchange
+ * sends rank r the elements of positions [r n / p, (r + 1) n / p). Keys equal across a boundary
+ * are split between the two ranks, so the final arrays differ in size by at most one element
+ * whatever the distribution. The local work is a counting sort before and after the exchange.
+ *
+ * Falls back to sample_sort() when the keys span more than `max_histogram_buckets` values.
+ */
+void histogram_sort(std::vector<i32>& local_array, work_stealing_pool& pool,
+                    MPI_Comm communicator);
+
+#endif // PARALLEL_QSORT_HISTOGRAM_SORT_HPP_
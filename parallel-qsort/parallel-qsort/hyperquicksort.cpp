@@ -0,0 +1,256 @@
+#include <parallel-qsort/hyperquicksort.hpp>
+
+#include <parallel-qsort/log.hpp>
+#include <parallel-qsort/trace.hpp>
+
+#include <libqsort/local_sort.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <iostream>
+#include <iterator>
+#include <memory>
+
+namespace
+{
+   /**
+    * Swaps the half of `local_array` that the partner keeps, `[send_begin, send_end)`, for its
+    * partner's half. The outgoing elements are staged in `outgoing`, the kept ones are compacted
+    * to the front by moving at most as many elements as were sent out, since the order of the
+    * local array is irrelevant until the final sort, and the incoming ones are received in place
+    * after them.
+    */
+   void exchange(std::vector<i32>& local_array, std::vector<i32>::iterator send_begin,
+                 std::vector<i32>::iterator send_end, std::vector<i32>& outgoing, i32 partner,
+                 i32 round, MPI_Comm comm)
+   {
+      scoped_phase timer(phase::exchange, round);
+
+      outgoing.assign(send_begin, send_end);
+
+      const i32 send_size = static_cast<i32>(outgoing.size());
+      const i32 keep_size = static_cast<i32>(local_array.size()) - send_size;
+
+      if (send_begin == begin(local_array))
+      {
+         // Only the tail of the kept half that lies past its new end has to move.
+         const i32 moved = std::min(send_size, keep_size);
+         std::move(end(local_array) - moved, end(local_array), begin(local_array));
+      }
+
+      i32 receive_size = 0;
+      MPI_Sendrecv(&send_size, 1, MPI_INT32_T, partner, 0, &receive_size, 1, MPI_INT32_T,
+                   partner, 0, comm, MPI_STATUS_IGNORE);
+
+      local_array.resize(keep_size + receive_size);
+
+      MPI_Sendrecv(outgoing.data(), send_size, MPI_INT32_T, partner, 1,
+                   local_array.data() + keep_size, receive_size, MPI_INT32_T, partner, 1, comm,
+                   MPI_STATUS_IGNORE);
+
+      timer.add_bytes(outgoing.size() * sizeof(i32));
+   }
+
+   /**
+    * Swaps `[send_begin, send_end)`, either end of the sorted `local_array`, for the partner's
+    * sorted half, received in `incoming` and merged with the kept part into `merged`, which then
+    * becomes the local array.
+    */
+   void exchange_sorted(std::vector<i32>& local_array, std::vector<i32>::iterator send_begin,
+                        std::vector<i32>::iterator send_end, std::vector<i32>& incoming,
+                        std::vector<i32>& merged, i32 partner, i32 round, MPI_Comm comm)
+   {
+      scoped_phase timer(phase::exchange, round);
+
+      const i32 send_size = static_cast<i32>(std::distance(send_begin, send_end));
+
+      i32 receive_size = 0;
+      MPI_Sendrecv(&send_size, 1, MPI_INT32_T, partner, 0, &receive_size, 1, MPI_INT32_T,
+                   partner, 0, comm, MPI_STATUS_IGNORE);
+
+      incoming.resize(receive_size);
+
+      MPI_Sendrecv(std::to_address(send_begin), send_size, MPI_INT32_T, partner, 1,
+                   incoming.data(), receive_size, MPI_INT32_T, partner, 1, comm,
+                   MPI_STATUS_IGNORE);
+
+      timer.add_bytes(static_cast<u64>(send_size) * sizeof(i32));
+      timer.finish();
+
+      const scoped_phase merge_timer(phase::merge, round);
+
+      const auto keep_begin = send_begin == begin(local_array) ? send_end : begin(local_array);
+      const auto keep_end = send_begin == begin(local_array) ? end(local_array) : send_begin;
+
+      merged.resize(std::distance(keep_begin, keep_end) + incoming.size());
+      std::merge(keep_begin, keep_end, begin(incoming), end(incoming), begin(merged));
+
+      local_array.swap(merged);
+   }
+
+   // Moves on to the half of `cube` holding this rank once the round along `dimension` is done.
+   void enter_sub_cube(MPI_Comm& cube, i32& local_rank, i64 dimension, i32 round,
+                       MPI_Comm communicator)
+   {
+      const scoped_phase timer(phase::comm_split, round);
+
+      int process_id = 0;
+      MPI_Comm_rank(communicator, &process_id);
+
+      MPI_Comm sub_cube = MPI_COMM_NULL;
+      MPI_Comm_split(cube, local_rank & (1 << dimension), process_id, &sub_cube);
+      if (cube != communicator)
+      {
+         MPI_Comm_free(&cube);
+      }
+
+      cube = sub_cube;
+      MPI_Comm_rank(cube, &local_rank);
+   }
+
+   // The largest local array over the mean, for the whole job, in verbose builds only since it
+   // synchronizes the ranks.
+   void report_imbalance(i32 round, std::size_t local_size, MPI_Comm communicator)
+   {
+      if constexpr (verbose_logging)
+      {
+         int process_id = 0;
+         MPI_Comm_rank(communicator, &process_id);
+
+         const f64 imbalance = load_imbalance(local_size, communicator);
+         if (process_id == 0)
+         {
+            std::cout << "round " << round << " - imbalance: " << imbalance << '\n';
+         }
+      }
+   }
+} // namespace
+
+void hyperquicksort(std::vector<i32>& local_array, pivot_rule rule,
+                    std::mt19937_64& sample_engine, work_stealing_pool& pool,
+                    MPI_Comm communicator)
+{
+   int process_id = 0;
+   int process_count = 0;
+   MPI_Comm_rank(communicator, &process_id);
+   MPI_Comm_size(communicator, &process_count);
+
+   MPI_Comm cube = communicator;
+   i32 local_rank = process_id;
+
+   // Stages the outgoing half of every round, its capacity carries over from one to the next.
+   std::vector<i32> outgoing;
+
+   const i64 dimensions = std::bit_width(static_cast<u32>(process_count)) - 1;
+   for (i64 i = dimensions - 1; i >= 0; --i)
+   {
+      const i32 round = static_cast<i32>(dimensions - i);
+
+      scoped_phase pivot_timer(phase::pivot, round);
+      const i32 pivot = choose_pivot(rule, local_array, sample_engine, cube);
+      pivot_timer.finish();
+
+      verbose_log(process_id, "pivot = ", pivot);
+      verbose_log(process_id, "elements = ", local_array.size());
+
+      scoped_phase partition_timer(phase::partition, round);
+      const auto separator = std::partition(begin(local_array), end(local_array), [=](i64 v) {
+         return v < pivot;
+      });
+      partition_timer.finish();
+
+      const i32 partner = local_rank ^ (1 << i);
+
+      if ((local_rank & (1 << i)) == 0)
+      {
+         verbose_log(process_id, "exchanging high-list");
+
+         exchange(local_array, separator, end(local_array), outgoing, partner, round, cube);
+      }
+      else
+      {
+         verbose_log(process_id, "exchanging low-list");
+
+         exchange(local_array, begin(local_array), separator, outgoing, partner, round, cube);
+      }
+
+      enter_sub_cube(cube, local_rank, i, round, communicator);
+      report_imbalance(round, local_array.size(), communicator);
+   }
+
+   if (cube != communicator)
+   {
+      MPI_Comm_free(&cube);
+   }
+
+   verbose_log(process_id, "performing local quicksort");
+
+   const scoped_phase timer(phase::local_sort);
+   local_sort(pool, begin(local_array), end(local_array));
+}
+
+void merging_hyperquicksort(std::vector<i32>& local_array, pivot_rule rule,
+                            std::mt19937_64& sample_engine, work_stealing_pool& pool,
+                            MPI_Comm communicator)
+{
+   int process_id = 0;
+   int process_count = 0;
+   MPI_Comm_rank(communicator, &process_id);
+   MPI_Comm_size(communicator, &process_count);
+
+   MPI_Comm cube = communicator;
+   i32 local_rank = process_id;
+
+   verbose_log(process_id, "performing local quicksort");
+
+   {
+      const scoped_phase timer(phase::local_sort);
+      local_sort(pool, begin(local_array), end(local_array));
+   }
+
+   // Receive and merge buffers, their capacity carries over from one round to the next.
+   std::vector<i32> incoming;
+   std::vector<i32> merged;
+
+   const i64 dimensions = std::bit_width(static_cast<u32>(process_count)) - 1;
+   for (i64 i = dimensions - 1; i >= 0; --i)
+   {
+      const i32 round = static_cast<i32>(dimensions - i);
+
+      scoped_phase pivot_timer(phase::pivot, round);
+      const i32 pivot = choose_pivot_of_sorted(rule, local_array, sample_engine, cube);
+      pivot_timer.finish();
+
+      verbose_log(process_id, "pivot = ", pivot);
+      verbose_log(process_id, "elements = ", local_array.size());
+
+      scoped_phase partition_timer(phase::partition, round);
+      const auto separator = std::lower_bound(begin(local_array), end(local_array), pivot);
+      partition_timer.finish();
+
+      const i32 partner = local_rank ^ (1 << i);
+
+      if ((local_rank & (1 << i)) == 0)
+      {
+         verbose_log(process_id, "merging with high-list");
+
+         exchange_sorted(local_array, separator, end(local_array), incoming, merged, partner,
+                         round, cube);
+      }
+      else
+      {
+         verbose_log(process_id, "merging with low-list");
+
+         exchange_sorted(local_array, begin(local_array), separator, incoming, merged, partner,
+                         round, cube);
+      }
+
+      enter_sub_cube(cube, local_rank, i, round, communicator);
+      report_imbalance(round, local_array.size(), communicator);
+   }
+
+   if (cube != communicator)
+   {
+      MPI_Comm_free(&cube);
+   }
+}
@@ -0,0 +1,35 @@
+#ifndef PARALLEL_QSORT_HYPERQUICKSORT_HPP_
+#define PARALLEL_QSORT_HYPERQUICKSORT_HPP_
+
+#include <parallel-qsort/pivot.hpp>
+#include <parallel-qsort/types.hpp>
+
+#include <libqsort/work_stealing_pool.hpp>
+
+#include <random>
+#include <vector>
+
+#include <mpi.h>
+
+/**
+ * Sorts the elements spread over the ranks of `communicator`, whose size must be a power of two.
+ * Each of the log2(p) rounds splits every sub-cube around a common pivot, the lower half of the
+ * ranks keeping the elements below the pivot and the upper half the others, and the local arrays
+ * are sorted on `pool` at the end. On return the local arrays are sorted and in rank order.
+ *
+ * Besides its local array, a rank only needs room for the half it sends out in a round.
+ */
+void hyperquicksort(std::vector<i32>& local_array, pivot_rule rule,
+                    std::mt19937_64& sample_engine, work_stealing_pool& pool,
+                    MPI_Comm communicator);
+
+/**
+ * The classic form of hyperquicksort(): every rank sorts its array first, so that its median is
+ * at hand for the pivot and each round splits the array with a binary search and merges the kept
+ * half with the received one in a single linear pass, instead of partitioning it.
+ */
+void merging_hyperquicksort(std::vector<i32>& local_array, pivot_rule rule,
+                            std::mt19937_64& sample_engine, work_stealing_pool& pool,
+                            MPI_Comm communicator);
+
+#endif // PARALLEL_QSORT_HYPERQUICKSORT_HPP_
@@ -0,0 +1,128 @@
+#ifndef PARALLEL_QSORT_KEY_INDEX_SORT_HPP_
+#define PARALLEL_QSORT_KEY_INDEX_SORT_HPP_
+
+#include <parallel-qsort/mpi_type.hpp>
+#include <parallel-qsort/sample_sort.hpp>
+#include <parallel-qsort/trace.hpp>
+#include <parallel-qsort/types.hpp>
+
+#include <libqsort/work_stealing_pool.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#include <mpi.h>
+
+// A key and the global index of the record it was extracted from.
+template <typename Key>
+struct keyed_index
+{
+   Key key;
+   u64 index;
+};
+
+/**
+ * sample_sort() for records much larger than their keys. Only (key, global index) pairs go through
+ * the sort and its exchange; each rank then asks the original owners for the records of its
+ * sorted indices, so every record crosses the network once, with the two all-to-alls of a request
+ * and its reply. Leaves the same distribution as sample_sort() of the records themselves.
+ */
+template <typename T, typename Key>
+void key_index_sort(std::vector<T>& local_records, work_stealing_pool& pool, MPI_Comm communicator,
+                    Key key)
+{
+   using key_type = std::remove_cvref_t<std::invoke_result_t<Key&, const T&>>;
+   using pair = keyed_index<key_type>;
+
+   int process_id = 0;
+   int process_count = 0;
+   MPI_Comm_rank(communicator, &process_id);
+   MPI_Comm_size(communicator, &process_count);
+
+   // Rank r held the records of global indices [bounds[r], bounds[r + 1]).
+   const u64 local_size = local_records.size();
+   auto bounds = std::vector<u64>(process_count + 1, 0);
+   MPI_Allgather(&local_size, 1, MPI_UINT64_T, bounds.data() + 1, 1, MPI_UINT64_T, communicator);
+   std::inclusive_scan(std::next(begin(bounds)), end(bounds), std::next(begin(bounds)));
+
+   auto pairs = std::vector<pair>(local_records.size());
+   for (std::size_t i = 0; i < pairs.size(); ++i)
+   {
+      pairs[i] = {std::invoke(key, local_records[i]), bounds[process_id] + i};
+   }
+
+   sample_sort(pairs, pool, communicator, &pair::key);
+
+   scoped_phase partition_timer(phase::partition);
+
+   // The requests are grouped by owner, `slots[i]` being where the record of `pairs[i]` arrives.
+   auto owners = std::vector<int>(pairs.size());
+   auto request_counts = std::vector<int>(process_count, 0);
+   for (std::size_t i = 0; i < pairs.size(); ++i)
+   {
+      owners[i] = static_cast<int>(std::ranges::upper_bound(bounds, pairs[i].index) -
+                                   begin(bounds)) - 1;
+      ++request_counts[owners[i]];
+   }
+
+   auto request_displacements = std::vector<int>(process_count, 0);
+   std::exclusive_scan(begin(request_counts), end(request_counts),
+                       begin(request_displacements), 0);
+
+   auto requests = std::vector<u64>(pairs.size());
+   auto slots = std::vector<int>(pairs.size());
+   auto next_slot = request_displacements;
+   for (std::size_t i = 0; i < pairs.size(); ++i)
+   {
+      slots[i] = next_slot[owners[i]]++;
+      requests[slots[i]] = pairs[i].index - bounds[owners[i]];
+   }
+
+   pairs = std::vector<pair>();
+   owners = std::vector<int>();
+
+   partition_timer.finish();
+
+   scoped_phase exchange_timer(phase::exchange);
+
+   auto serve_counts = std::vector<int>(process_count, 0);
+   MPI_Alltoall(request_counts.data(), 1, MPI_INT, serve_counts.data(), 1, MPI_INT,
+                communicator);
+
+   auto serve_displacements = std::vector<int>(process_count, 0);
+   std::exclusive_scan(begin(serve_counts), end(serve_counts), begin(serve_displacements), 0);
+
+   auto served = std::vector<u64>(serve_displacements.back() + serve_counts.back());
+   MPI_Alltoallv(requests.data(), request_counts.data(), request_displacements.data(),
+                 MPI_UINT64_T, served.data(), serve_counts.data(), serve_displacements.data(),
+                 MPI_UINT64_T, communicator);
+
+   auto replies = std::vector<T>(served.size());
+   for (std::size_t j = 0; j < served.size(); ++j)
+   {
+      replies[j] = local_records[served[j]];
+   }
+   local_records = std::vector<T>();
+
+   auto received = std::vector<T>(requests.size());
+   MPI_Alltoallv(replies.data(), serve_counts.data(), serve_displacements.data(),
+                 mpi_datatype<T>(), received.data(), request_counts.data(),
+                 request_displacements.data(), mpi_datatype<T>(), communicator);
+   exchange_timer.add_bytes((requests.size() - request_counts[process_id]) * sizeof(u64) +
+                            (replies.size() - serve_counts[process_id]) * sizeof(T));
+   exchange_timer.finish();
+
+   replies = std::vector<T>();
+
+   local_records.resize(received.size());
+   for (std::size_t i = 0; i < received.size(); ++i)
+   {
+      local_records[i] = received[slots[i]];
+   }
+}
+
+#endif // PARALLEL_QSORT_KEY_INDEX_SORT_HPP_
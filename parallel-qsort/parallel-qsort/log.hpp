@@ -0,0 +1,25 @@
+#ifndef PARALLEL_QSORT_LOG_HPP_
+#define PARALLEL_QSORT_LOG_HPP_
+
+#include <iostream>
+
+// Per-rank progress messages cost a trip through stdio on every rank and round, which serializes
+// the ranks and skews the phase timings, so they are only compiled in with
+// -DPARALLEL_QSORT_VERBOSE (config.cxx.poptions).
+#ifdef PARALLEL_QSORT_VERBOSE
+inline constexpr bool verbose_logging = true;
+#else
+inline constexpr bool verbose_logging = false;
+#endif
+
+// Prints "P<process_id> - " followed by `args` when verbose logging is compiled in.
+template <typename... Args>
+void verbose_log(int process_id, const Args&... args)
+{
+   if constexpr (verbose_logging)
+   {
+      ((std::cout << "P" << process_id << " - ") << ... << args) << '\n';
+   }
+}
+
+#endif // PARALLEL_QSORT_LOG_HPP_
@@ -0,0 +1,78 @@
+#ifndef PARALLEL_QSORT_MPI_TYPE_HPP_
+#define PARALLEL_QSORT_MPI_TYPE_HPP_
+
+#include <parallel-qsort/types.hpp>
+
+#include <type_traits>
+
+#include <mpi.h>
+
+/**
+ * The MPI datatype of `T`, so that templated exchanges move elements without packing them by
+ * hand. Integers and floating point map to the predefined types. Any other trivially copyable
+ * type moves as one contiguous block of its bytes, a layout valid between ranks of the same
+ * architecture; specialize this for a type that needs a struct layout.
+ */
+template <typename T>
+struct mpi_type
+{
+   static_assert(std::is_trivially_copyable_v<T>, "elements are sent as their bytes");
+
+   static auto get() -> MPI_Datatype
+   {
+      // Committed on first use, after MPI_Init, and kept until MPI_Finalize.
+      static const MPI_Datatype type = [] {
+         MPI_Datatype bytes = MPI_DATATYPE_NULL;
+         MPI_Type_contiguous(static_cast<int>(sizeof(T)), MPI_BYTE, &bytes);
+         MPI_Type_commit(&bytes);
+
+         return bytes;
+      }();
+
+      return type;
+   }
+};
+
+template <>
+struct mpi_type<i32>
+{
+   static auto get() -> MPI_Datatype
+   {
+      return MPI_INT32_T;
+   }
+};
+
+template <>
+struct mpi_type<i64>
+{
+   static auto get() -> MPI_Datatype
+   {
+      return MPI_INT64_T;
+   }
+};
+
+template <>
+struct mpi_type<u64>
+{
+   static auto get() -> MPI_Datatype
+   {
+      return MPI_UINT64_T;
+   }
+};
+
+template <>
+struct mpi_type<f64>
+{
+   static auto get() -> MPI_Datatype
+   {
+      return MPI_DOUBLE;
+   }
+};
+
+template <typename T>
+auto mpi_datatype() -> MPI_Datatype
+{
+   return mpi_type<T>::get();
+}
+
+#endif // PARALLEL_QSORT_MPI_TYPE_HPP_
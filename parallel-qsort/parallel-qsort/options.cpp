@@ -0,0 +1,218 @@
+#include <parallel-qsort/options.hpp>
+
+#include <algorithm>
+#include <charconv>
+#include <string_view>
+
+namespace
+{
+   template <typename T>
+   auto parse_number(std::string_view name, std::string_view text) -> std::expected<T, std::string>
+   {
+      T value{};
+      const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+      if (error != std::errc() or end != text.data() + text.size())
+      {
+         return std::unexpected("invalid value '" + std::string(text) + "' for " +
+                                std::string(name));
+      }
+
+      return value;
+   }
+
+   // Parses the value following the option at `args[i]` and moves `i` past it.
+   template <typename T>
+   auto next_number(std::span<char*> args, std::size_t& i) -> std::expected<T, std::string>
+   {
+      const std::string_view name = args[i];
+      if (i + 1 >= args.size())
+      {
+         return std::unexpected("missing value for " + std::string(name));
+      }
+
+      return parse_number<T>(name, args[++i]);
+   }
+
+   // The value following the option at `args[i]`, moving `i` past it.
+   auto next_string(std::span<char*> args, std::size_t& i)
+      -> std::expected<std::string_view, std::string>
+   {
+      const std::string_view name = args[i];
+      if (i + 1 >= args.size())
+      {
+         return std::unexpected("missing value for " + std::string(name));
+      }
+
+      return args[++i];
+   }
+} // namespace
+
+auto parse_options(std::span<char*> args) -> std::expected<options, std::string>
+{
+   options result;
+
+   for (std::size_t i = 1; i < args.size(); ++i)
+   {
+      const std::string_view arg = args[i];
+
+      if (arg == "--seed")
+      {
+         const auto seed = next_number<u64>(args, i);
+         if (not seed)
+         {
+            return std::unexpected(seed.error());
+         }
+
+         result.seed = *seed;
+      }
+      else if (arg == "--elements")
+      {
+         const auto element_count = next_number<u64>(args, i);
+         if (not element_count)
+         {
+            return std::unexpected(element_count.error());
+         }
+
+         result.element_count = *element_count;
+      }
+      else if (arg == "--threads")
+      {
+         const auto thread_count = next_number<u32>(args, i);
+         if (not thread_count)
+         {
+            return std::unexpected(thread_count.error());
+         }
+
+         result.thread_count = *thread_count;
+      }
+      else if (arg == "--payload")
+      {
+         const auto payload_size = next_number<u32>(args, i);
+         if (not payload_size)
+         {
+            return std::unexpected(payload_size.error());
+         }
+
+         result.payload_size = *payload_size;
+      }
+      else if (arg == "--key-index")
+      {
+         result.key_index = true;
+      }
+      else if (arg == "--input")
+      {
+         const auto path = next_string(args, i);
+         if (not path)
+         {
+            return std::unexpected(path.error());
+         }
+
+         result.input = *path;
+      }
+      else if (arg == "--output")
+      {
+         const auto path = next_string(args, i);
+         if (not path)
+         {
+            return std::unexpected(path.error());
+         }
+
+         result.output = *path;
+      }
+      else if (arg == "--trace")
+      {
+         const auto path = next_string(args, i);
+         if (not path)
+         {
+            return std::unexpected(path.error());
+         }
+
+         result.trace = *path;
+      }
+      else if (arg == "--output-format")
+      {
+         const std::string_view name = i + 1 < args.size() ? args[++i] : "";
+         if (name == "binary")
+         {
+            result.format = output_format::binary;
+         }
+         else if (name == "text")
+         {
+            result.format = output_format::text;
+         }
+         else
+         {
+            return std::unexpected("--output-format must be one of binary, text");
+         }
+      }
+      else if (arg == "--algorithm")
+      {
+         const std::string_view name = i + 1 < args.size() ? args[++i] : "";
+         if (name == "hyperquicksort")
+         {
+            result.algorithm = sort_algorithm::hyperquicksort;
+         }
+         else if (name == "hyperquicksort-merge")
+         {
+            result.algorithm = sort_algorithm::merging_hyperquicksort;
+         }
+         else if (name == "psrs")
+         {
+            result.algorithm = sort_algorithm::sample_sort;
+         }
+         else if (name == "histogram")
+         {
+            result.algorithm = sort_algorithm::histogram_sort;
+         }
+         else
+         {
+            return std::unexpected("--algorithm must be one of hyperquicksort, "
+                                   "hyperquicksort-merge, psrs, histogram");
+         }
+      }
+      else if (arg == "--pivot")
+      {
+         const std::string_view name = i + 1 < args.size() ? args[++i] : "";
+         if (name == "mean")
+         {
+            result.pivot = pivot_rule::mean;
+         }
+         else if (name == "sample")
+         {
+            result.pivot = pivot_rule::sample_median;
+         }
+         else if (name == "weighted-median")
+         {
+            result.pivot = pivot_rule::weighted_median;
+         }
+         else
+         {
+            return std::unexpected("--pivot must be one of mean, sample, weighted-median");
+         }
+      }
+      else
+      {
+         return std::unexpected("unknown option " + std::string(arg));
+      }
+   }
+
+   if (result.payload_size != 0 and
+       std::ranges::find(record_payload_sizes, result.payload_size) == end(record_payload_sizes))
+   {
+      return std::unexpected("--payload must be one of 0, 24, 56");
+   }
+   if (result.key_index and result.payload_size == 0)
+   {
+      return std::unexpected("--key-index needs a --payload");
+   }
+   if (result.payload_size != 0 and (result.input or result.output))
+   {
+      return std::unexpected("records are generated, --input and --output hold bare keys");
+   }
+   if (result.format != output_format::binary and not result.output)
+   {
+      return std::unexpected("--output-format needs an --output file");
+   }
+
+   return result;
+}
@@ -0,0 +1,63 @@
+#ifndef PARALLEL_QSORT_OPTIONS_HPP_
+#define PARALLEL_QSORT_OPTIONS_HPP_
+
+#include <parallel-qsort/file_io.hpp>
+#include <parallel-qsort/pivot.hpp>
+#include <parallel-qsort/types.hpp>
+
+#include <array>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+
+enum class sort_algorithm
+{
+   hyperquicksort,         // log2(p) rounds of pairwise exchanges, p must be a power of two
+   merging_hyperquicksort, // the same rounds on sorted arrays, merging rather than partitioning
+   sample_sort,            // parallel sorting by regular sampling, a single all-to-all exchange
+   histogram_sort          // global key histogram, a single all-to-all exchange
+};
+
+// Record payload sizes with a compiled record type.
+inline constexpr std::array<u32, 2> record_payload_sizes = {24, 56};
+
+// Default number of elements to sort.
+inline constexpr u64 default_element_count = 10000;
+
+struct options
+{
+   // Seeds the input on rank 0 and the pivot samples on every rank.
+   std::optional<u64> seed;
+
+   // Elements generated on rank 0 when there is no input file.
+   u64 element_count = default_element_count;
+
+   // Binary file of native i32 read in slices by every rank, instead of generated input.
+   std::optional<std::filesystem::path> input;
+
+   // File the sorted partitions are written to by every rank, instead of printed by rank 0.
+   std::optional<std::filesystem::path> output;
+   output_format format = output_format::binary;
+
+   // Chrome trace of the phases of every rank, written by rank 0.
+   std::optional<std::filesystem::path> trace;
+
+   // Bytes of payload carried by every generated record, 0 sorts bare i32 keys. Records are
+   // always sorted by sample sort, `algorithm` only applies to bare keys.
+   u32 payload_size = 0;
+
+   // Sorts (key, index) pairs and moves the records once at the end.
+   bool key_index = false;
+
+   // Threads of the work stealing pool of every rank, 0 starts one per CPU available to the rank.
+   u32 thread_count = 0;
+
+   sort_algorithm algorithm = sort_algorithm::hyperquicksort;
+   pivot_rule pivot = pivot_rule::sample_median;
+};
+
+auto parse_options(std::span<char*> args) -> std::expected<options, std::string>;
+
+#endif // PARALLEL_QSORT_OPTIONS_HPP_
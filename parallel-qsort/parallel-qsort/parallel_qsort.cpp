@@ -1,8 +1,26 @@
+#include <parallel-qsort/file_io.hpp>
+#include <parallel-qsort/histogram_sort.hpp>
+#include <parallel-qsort/hyperquicksort.hpp>
+#include <parallel-qsort/key_index_sort.hpp>
+#include <parallel-qsort/log.hpp>
+#include <parallel-qsort/options.hpp>
+#include <parallel-qsort/pivot.hpp>
+#include <parallel-qsort/record.hpp>
+#include <parallel-qsort/sample_sort.hpp>
+#include <parallel-qsort/seeding.hpp>
+#include <parallel-qsort/trace.hpp>
+#include <parallel-qsort/types.hpp>
+
+#include <libqsort/work_stealing_pool.hpp>
+
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <ctime>
 #include <iostream>
 #include <iterator>
+#include <limits>
+#include <numeric>
 #include <random>
 #include <string>
 #include <vector>
@@ -12,51 +30,19 @@
 using std::begin;
 using std::end;
 using std::next;
-using std::partition;
 using std::prev;
 
-using u16 = std::uint16_t;
-using u32 = std::uint32_t;
-using u64 = std::uint64_t;
-using i16 = std::int16_t;
-using i32 = std::int32_t;
-using i64 = std::int64_t;
-using f64 = double;
-
 static constexpr i64 random_generation_bound = 1000;
-static constexpr i64 total_elements = 10000;
-
-template <typename It>
-void qsort(It beg, It end)
-{
-   using value_type = typename std::iterator_traits<It>::value_type;
-
-   if (beg < end)
-   {
-      const auto pivot = std::prev(end);
-      const auto separator = std::partition(beg, std::prev(end), [pivot](const value_type& v) {
-         return v < *pivot;
-      });
-
-      std::iter_swap(separator, pivot);
-
-      qsort(beg, separator);
-      qsort(std::next(separator), end);
-   }
-}
 
-auto generate_random_array(i64 count) -> std::vector<i32>;
+auto generate_random_array(i64 count, u64 seed) -> std::vector<i32>;
 
 template <typename It>
-auto compute_median_pivot(It begin, It end) -> i32;
+auto format_range(It begin, It end) -> std::string;
 
-template <typename It>
-void send_list(It begin, It end, i32 target, MPI_Comm comm);
-template <typename It>
-auto receive_list(It buffer_begin, i32 target, MPI_Comm comm) -> It;
+template <std::size_t PayloadSize>
+auto sort_records(const options& opts, u64 seed, work_stealing_pool& pool) -> bool;
 
-template <typename It>
-auto format_range(It begin, It end) -> std::string;
+auto report_phases(const options& opts) -> bool;
 
 auto is_power_of_2(i32 n) -> bool;
 
@@ -72,111 +58,217 @@ auto main(int argc, char* argv[]) -> int
    MPI_Comm_size(MPI_COMM_WORLD, &process_count);
    MPI_Comm_rank(MPI_COMM_WORLD, &process_id);
 
-   if (not is_power_of_2(process_count))
+   const auto opts = parse_options({argv, static_cast<std::size_t>(argc)});
+   if (not opts)
+   {
+      if (process_id == 0)
+      {
+         std::cout << "error: " << opts.error() << '\n';
+      }
+
+      MPI_Finalize();
+
+      return EXIT_FAILURE;
+   }
+
+   const bool hypercube = opts->payload_size == 0 and
+                          (opts->algorithm == sort_algorithm::hyperquicksort or
+                           opts->algorithm == sort_algorithm::merging_hyperquicksort);
+   if (hypercube and not is_power_of_2(process_count))
    {
-      std::cout << "Process count (" << process_count << ") is not a power of 2\n";
+      if (process_id == 0)
+      {
+         std::cout << "error: hyperquicksort needs a power of 2 process count, not "
+                   << process_count << '\n';
+      }
+
+      MPI_Finalize();
 
       return EXIT_FAILURE;
    }
 
-   const i64 elements_per_core = static_cast<i64>(
-      std::floor(static_cast<f64>(total_elements) / static_cast<f64>(process_count)));
+   rank_trace().start(MPI_COMM_WORLD);
+
+   i64 total_elements = static_cast<i64>(opts->element_count);
+
    std::vector<i32> data_buffer;
-   i32 pivot = 0;
+   std::vector<i32> local_array;
 
+   u64 seed = 0;
    if (process_id == 0)
    {
-      data_buffer = generate_random_array(total_elements);
-      pivot = compute_median_pivot(begin(data_buffer), end(data_buffer));
-
-      std::cout << "Sorting " << total_elements << " elements\n";
+      std::random_device rd;
+      seed = opts->seed.value_or((static_cast<u64>(rd()) << 32) | rd());
    }
-   else
+
+   MPI_Bcast(&seed, 1, MPI_UINT64_T, 0, MPI_COMM_WORLD);
+
+   // Printed first, so a run can be replayed with --seed whatever happens next.
+   if (process_id == 0)
    {
-      data_buffer = std::vector<i32>(total_elements, 0);
+      std::cout << "seed: " << seed << '\n';
    }
 
-   auto local_array = std::vector<i32>(elements_per_core);
+   // Sizing the pool on the whole affinity mask oversubscribes the cores shared by several ranks
+   // of a node, --threads bounds it.
+   const u32 thread_count = opts->thread_count == 0 ? available_cpu_count() : opts->thread_count;
 
-   MPI_Scatter(static_cast<void*>(data_buffer.data()), static_cast<i32>(elements_per_core),
-               MPI_INT32_T, static_cast<void*>(local_array.data()),
-               static_cast<i32>(elements_per_core), MPI_INT32_T, 0, MPI_COMM_WORLD);
-   MPI_Bcast(&pivot, 1, MPI_INT32_T, 0, MPI_COMM_WORLD);
+   if (opts->payload_size != 0)
+   {
+      auto pool = work_stealing_pool(thread_count);
 
-   std::cout << "P" << process_id << " - " << elements_per_core << " random integers received\n";
+      const bool sorted = opts->payload_size == 24 ? sort_records<24>(*opts, seed, pool)
+                                                   : sort_records<56>(*opts, seed, pool);
 
-   auto* communicator = MPI_COMM_WORLD;
+      const f64 elapsed_time = MPI_Wtime() - start_time;
+      const bool reported = report_phases(*opts);
+      MPI_Finalize();
 
-   i32 local_rank = process_id;
+      if (process_id == 0)
+      {
+         std::cout << "records sorted: " << (sorted ? "yes" : "no") << '\n';
+         std::cout << "elapsed time: " << elapsed_time << '\n';
+      }
+
+      return sorted and reported ? 0 : EXIT_FAILURE;
+   }
 
-   const i64 dimensions = static_cast<i64>(std::log2(process_count));
-   for (i64 i = dimensions - 1; i >= 0; --i)
+   if (opts->input)
    {
-      std::cout << "P" << process_id << " - pivot = " << pivot << "\n";
-      std::cout << "P" << process_id << " - elements = " << local_array.size() << "\n";
+      scoped_phase distribute_timer(phase::distribute);
+      auto partition = read_partition(*opts->input, MPI_COMM_WORLD);
+      distribute_timer.finish();
 
-      const auto separator = partition(begin(local_array), end(local_array), [=](i64 v) {
-         return v < pivot;
-      });
+      if (not partition)
+      {
+         if (process_id == 0)
+         {
+            std::cout << "error: " << partition.error() << '\n';
+         }
 
-      const i32 target = local_rank ^ (1 << i);
-      const i64 local_low_list_size = std::distance(begin(local_array), separator);
-      const i64 local_high_list_size = std::distance(separator, end(local_array));
+         MPI_Finalize();
 
-      if ((process_id & (1 << i)) == 0)
-      {
-         std::cout << "P" << process_id << " - sending high-list\n";
+         return EXIT_FAILURE;
+      }
 
-         send_list(separator, end(local_array), target, communicator);
+      local_array = std::move(*partition);
 
-         std::cout << "P" << process_id << " - receiving low-list\n";
+      i64 local_size = static_cast<i64>(local_array.size());
+      MPI_Allreduce(&local_size, &total_elements, 1, MPI_INT64_T, MPI_SUM, MPI_COMM_WORLD);
 
-         const auto recv_end = receive_list(begin(data_buffer), target, communicator);
+      if (process_id == 0)
+      {
+         std::cout << "Sorting " << total_elements << " elements\n";
+      }
 
-         std::cout << "P" << process_id << " - merging\n";
+      verbose_log(process_id, local_array.size(), " integers read");
+   }
+   else
+   {
+      if (process_id == 0)
+      {
+         data_buffer = generate_random_array(total_elements, seed);
 
-         const i64 recv_size = std::distance(begin(data_buffer), recv_end);
+         std::cout << "Sorting " << total_elements << " elements\n";
+      }
 
-         local_array.resize(local_low_list_size + recv_size);
-         std::copy(begin(data_buffer), recv_end, begin(local_array) + local_low_list_size);
+      // The first `total_elements % process_count` ranks take one extra element.
+      auto scatter_sizes = std::vector<i32>(process_count);
+      auto scatter_displacements = std::vector<i32>(process_count, 0);
+      for (i32 rank = 0; rank < process_count; ++rank)
+      {
+         scatter_sizes[rank] = static_cast<i32>(total_elements / process_count +
+                                                (rank < total_elements % process_count ? 1 : 0));
       }
-      else
+      std::partial_sum(begin(scatter_sizes), prev(end(scatter_sizes)),
+                       next(begin(scatter_displacements)));
+
+      local_array.resize(scatter_sizes[process_id]);
+
+      scoped_phase distribute_timer(phase::distribute);
+      if (process_id == 0)
       {
-         std::cout << "P" << process_id << " - receiving high-list\n";
+         distribute_timer.add_bytes((total_elements - scatter_sizes[0]) * sizeof(i32));
+      }
 
-         const auto recv_end = receive_list(begin(data_buffer), target, communicator);
+      MPI_Scatterv(data_buffer.data(), scatter_sizes.data(), scatter_displacements.data(),
+                   MPI_INT32_T, local_array.data(), scatter_sizes[process_id], MPI_INT32_T, 0,
+                   MPI_COMM_WORLD);
 
-         std::cout << "P" << process_id << " - sending low-list\n";
+      distribute_timer.finish();
 
-         send_list(begin(local_array), separator, target, communicator);
+      verbose_log(process_id, local_array.size(), " random integers received");
+   }
 
-         std::cout << "P" << process_id << " - merging\n";
+   auto pool = work_stealing_pool(thread_count);
 
-         const i64 recv_size = std::distance(begin(data_buffer), recv_end);
+   // Each rank draws its own pivot samples.
+   auto sample_engine = seeded_engine<std::mt19937_64>({seed, static_cast<u64>(process_id)});
 
-         std::rotate(begin(local_array), begin(local_array) + local_low_list_size,
-                     end(local_array));
-         local_array.resize(local_high_list_size + recv_size);
-         std::copy(begin(data_buffer), recv_end, begin(local_array) + local_high_list_size);
-      }
+   switch (opts->algorithm)
+   {
+      case sort_algorithm::hyperquicksort:
+         hyperquicksort(local_array, opts->pivot, sample_engine, pool, MPI_COMM_WORLD);
+         break;
+      case sort_algorithm::merging_hyperquicksort:
+         merging_hyperquicksort(local_array, opts->pivot, sample_engine, pool, MPI_COMM_WORLD);
+         break;
+      case sort_algorithm::sample_sort:
+         sample_sort(local_array, pool, MPI_COMM_WORLD);
+         break;
+      case sort_algorithm::histogram_sort:
+         histogram_sort(local_array, pool, MPI_COMM_WORLD);
+         break;
+   }
 
-      if (i >= 0)
-      {
-         MPI_Comm_split(communicator, local_rank & (1 << i), process_id, &communicator);
-         MPI_Comm_rank(communicator, &local_rank);
+   const f64 imbalance = load_imbalance(local_array.size(), MPI_COMM_WORLD);
+   if (process_id == 0)
+   {
+      std::cout << "load imbalance: " << imbalance << '\n';
+   }
 
-         if (local_rank == 0)
+   if (opts->output)
+   {
+      scoped_phase gather_timer(phase::gather);
+      gather_timer.add_bytes(local_array.size() * sizeof(i32));
+
+      const auto written =
+         write_partition(*opts->output, local_array, opts->format, MPI_COMM_WORLD);
+
+      gather_timer.finish();
+
+      const f64 elapsed_time = MPI_Wtime() - start_time;
+      const bool reported = report_phases(*opts);
+      MPI_Finalize();
+
+      if (not written)
+      {
+         if (process_id == 0)
          {
-            pivot = compute_median_pivot(begin(local_array), end(local_array));
+            std::cout << "error: " << written.error() << '\n';
          }
 
-         MPI_Bcast(&pivot, 1, MPI_INT32_T, 0, communicator);
+         return EXIT_FAILURE;
       }
+
+      if (process_id == 0)
+      {
+         std::cout << "elapsed time: " << elapsed_time << '\n';
+      }
+
+      return reported ? 0 : EXIT_FAILURE;
    }
 
-   std::cout << "P" << process_id << " - performing local quicksort\n";
+   if (process_id == 0)
+   {
+      data_buffer.resize(total_elements);
+   }
 
-   qsort(begin(local_array), end(local_array));
+   scoped_phase gather_timer(phase::gather);
+   if (process_id != 0)
+   {
+      gather_timer.add_bytes(local_array.size() * sizeof(i32));
+   }
 
    i32 local_size = static_cast<i32>(local_array.size());
    auto sizes = std::vector<i32>(process_count, 0);
@@ -190,24 +282,24 @@ auto main(int argc, char* argv[]) -> int
                data_buffer.data(), sizes.data(), displacements.data(), MPI_INT32_T, 0,
                MPI_COMM_WORLD);
 
+   gather_timer.finish();
+
    const f64 elapsed_time = MPI_Wtime() - start_time;
+   const bool reported = report_phases(*opts);
    MPI_Finalize();
 
    if (process_id == 0)
    {
-      i64 true_size = elements_per_core * process_count;
-      std::cout << "data: {" << format_range(begin(data_buffer), begin(data_buffer) + true_size)
-                << "}\n";
+      std::cout << "data: {" << format_range(begin(data_buffer), end(data_buffer)) << "}\n";
       std::cout << "elapsed time: " << elapsed_time << '\n';
    }
 
-   return 0;
+   return reported ? 0 : EXIT_FAILURE;
 }
 
-auto generate_random_array(i64 count) -> std::vector<i32>
+auto generate_random_array(i64 count, u64 seed) -> std::vector<i32>
 {
-   std::random_device rd;
-   auto random_engine = std::default_random_engine(rd());
+   auto random_engine = std::mt19937_64(seed);
    auto distribution = std::uniform_int_distribution<i32>(0, random_generation_bound);
 
    auto data = std::vector<i32>(count);
@@ -220,44 +312,122 @@ auto generate_random_array(i64 count) -> std::vector<i32>
 }
 
 template <typename It>
-auto compute_median_pivot(It begin, It end) -> i32
+auto format_range(It begin, It end) -> std::string
 {
-   const i32 size = std::distance(begin, end);
-   const i32 sum = std::accumulate(begin, end, 0);
-   const float median = static_cast<float>(sum) / static_cast<float>(size);
+   std::string str = " ";
+   std::for_each(begin, end, [&](const auto& v) {
+      str += std::to_string(v);
+      str += " ";
+   });
 
-   return static_cast<i32>(std::ceil(median));
+   return str;
 }
 
-template <typename It>
-void send_list(It begin, It end, i32 target, MPI_Comm comm)
+// Payload bytes derived from the key, so that a payload separated from its key is detected.
+auto payload_byte(i32 key, std::size_t i) -> std::byte
 {
-   i32 size = std::distance(begin, end);
-
-   MPI_Send(&size, 1, MPI_INT32_T, target, 0, comm);
-   MPI_Send(begin.base(), size, MPI_INT32_T, target, 0, comm);
+   return static_cast<std::byte>((static_cast<u32>(key) >> (8 * (i % 4))) ^ i);
 }
-template <typename It>
-auto receive_list(It buffer_begin, i32 target, MPI_Comm comm) -> It
+
+/**
+ * Generates this rank's share of `opts.element_count` records, sorts them across the job by key,
+ * through key_index_sort() or sample_sort(), and checks that the keys are sorted over the job,
+ * that none were lost and that every payload still belongs to its key. Collective.
+ */
+template <std::size_t PayloadSize>
+auto sort_records(const options& opts, u64 seed, work_stealing_pool& pool) -> bool
 {
-   i32 recv_size = 0;
-   MPI_Recv(&recv_size, 1, MPI_INT32_T, target, 0, comm, nullptr);
+   using value_type = record<PayloadSize>;
+
+   int process_id = 0;
+   int process_count = 0;
+   MPI_Comm_rank(MPI_COMM_WORLD, &process_id);
+   MPI_Comm_size(MPI_COMM_WORLD, &process_count);
+
+   const u64 rank = static_cast<u64>(process_id);
+   const u64 ranks = static_cast<u64>(process_count);
+   const u64 local_size = opts.element_count / ranks + (rank < opts.element_count % ranks ? 1 : 0);
+
+   if (process_id == 0)
+   {
+      std::cout << "Sorting " << opts.element_count << " records of " << sizeof(value_type)
+                << " bytes\n";
+   }
+
+   auto random_engine = seeded_engine<std::mt19937_64>({seed, rank});
+   auto distribution = std::uniform_int_distribution<i32>(0, random_generation_bound);
+
+   auto local_records = std::vector<value_type>(local_size);
+   for (auto& value : local_records)
+   {
+      value.key = distribution(random_engine);
+      for (std::size_t i = 0; i < PayloadSize; ++i)
+      {
+         value.payload[i] = payload_byte(value.key, i);
+      }
+   }
+
+   if (opts.key_index)
+   {
+      key_index_sort(local_records, pool, MPI_COMM_WORLD, record_key{});
+   }
+   else
+   {
+      sample_sort(local_records, pool, MPI_COMM_WORLD, record_key{});
+   }
+
+   bool valid = std::ranges::is_sorted(local_records, {}, record_key{});
+   for (const auto& value : local_records)
+   {
+      for (std::size_t i = 0; i < PayloadSize; ++i)
+      {
+         valid = valid and value.payload[i] == payload_byte(value.key, i);
+      }
+   }
 
-   MPI_Recv(buffer_begin.base(), recv_size, MPI_INT32_T, target, 0, comm, nullptr);
+   // The largest key of the ranks before this one may not exceed its smallest.
+   i64 last_key = local_records.empty() ? std::numeric_limits<i64>::min()
+                                        : static_cast<i64>(local_records.back().key);
+   i64 previous_key = std::numeric_limits<i64>::min();
+   MPI_Exscan(&last_key, &previous_key, 1, MPI_INT64_T, MPI_MAX, MPI_COMM_WORLD);
+   if (process_id != 0 and not local_records.empty())
+   {
+      valid = valid and previous_key <= local_records.front().key;
+   }
 
-   return buffer_begin + recv_size;
+   u64 sorted_size = local_records.size();
+   MPI_Allreduce(MPI_IN_PLACE, &sorted_size, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+
+   int all_valid = valid and sorted_size == opts.element_count ? 1 : 0;
+   MPI_Allreduce(MPI_IN_PLACE, &all_valid, 1, MPI_INT, MPI_LAND, MPI_COMM_WORLD);
+
+   return all_valid == 1;
 }
 
-template <typename It>
-auto format_range(It begin, It end) -> std::string
+// Prints the time spent in each phase over the job and writes the Chrome trace asked for by
+// --trace. Collective.
+auto report_phases(const options& opts) -> bool
 {
-   std::string str = " ";
-   std::for_each(begin, end, [&](const auto& v) {
-      str += std::to_string(v);
-      str += " ";
-   });
+   int process_id = 0;
+   MPI_Comm_rank(MPI_COMM_WORLD, &process_id);
 
-   return str;
+   print_phase_report(MPI_COMM_WORLD);
+
+   if (opts.trace)
+   {
+      const auto written = write_chrome_trace(*opts.trace, MPI_COMM_WORLD);
+      if (not written)
+      {
+         if (process_id == 0)
+         {
+            std::cout << "error: " << written.error() << '\n';
+         }
+
+         return false;
+      }
+   }
+
+   return true;
 }
 
 auto is_power_of_2(i32 n) -> bool
@@ -0,0 +1,159 @@
+#include <parallel-qsort/pivot.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+namespace
+{
+   auto mean_pivot(std::span<const i32> local, MPI_Comm communicator) -> i32
+   {
+      // {sum, count}, in 64 bits so that large arrays cannot overflow the sum.
+      std::array<i64, 2> local_totals = {std::accumulate(begin(local), end(local), i64{0}),
+                                         static_cast<i64>(local.size())};
+      std::array<i64, 2> totals = {};
+      MPI_Allreduce(local_totals.data(), totals.data(), 2, MPI_INT64_T, MPI_SUM, communicator);
+
+      if (totals[1] == 0)
+      {
+         return 0;
+      }
+
+      return static_cast<i32>(
+         std::ceil(static_cast<f64>(totals[0]) / static_cast<f64>(totals[1])));
+   }
+
+   auto sample_median_pivot(std::span<const i32> local, std::mt19937_64& engine,
+                            MPI_Comm communicator) -> i32
+   {
+      int rank_count = 0;
+      MPI_Comm_size(communicator, &rank_count);
+
+      // Drawn with replacement, an empty rank has nothing to contribute.
+      std::vector<i32> sample;
+      if (not local.empty())
+      {
+         auto index = std::uniform_int_distribution<std::size_t>(0, local.size() - 1);
+
+         sample.resize(pivot_sample_size);
+         for (auto& value : sample)
+         {
+            value = local[index(engine)];
+         }
+      }
+
+      const int sample_size = static_cast<int>(sample.size());
+      auto sample_sizes = std::vector<int>(rank_count);
+      MPI_Allgather(&sample_size, 1, MPI_INT, sample_sizes.data(), 1, MPI_INT, communicator);
+
+      auto displacements = std::vector<int>(rank_count, 0);
+      std::exclusive_scan(begin(sample_sizes), end(sample_sizes), begin(displacements), 0);
+
+      auto samples = std::vector<i32>(displacements.back() + sample_sizes.back());
+      MPI_Allgatherv(sample.data(), sample_size, MPI_INT32_T, samples.data(), sample_sizes.data(),
+                     displacements.data(), MPI_INT32_T, communicator);
+
+      if (samples.empty())
+      {
+         return 0;
+      }
+
+      const auto median = begin(samples) + static_cast<std::ptrdiff_t>(samples.size() / 2);
+      std::nth_element(begin(samples), median, end(samples));
+
+      return *median;
+   }
+
+   auto weighted_median_pivot(i32 median, std::size_t size, MPI_Comm communicator) -> i32
+   {
+      int rank_count = 0;
+      MPI_Comm_size(communicator, &rank_count);
+
+      // {median, size} of every rank.
+      std::array<i64, 2> local_median = {median, static_cast<i64>(size)};
+
+      auto medians = std::vector<std::array<i64, 2>>(rank_count);
+      MPI_Allgather(local_median.data(), 2, MPI_INT64_T, medians.data(), 2, MPI_INT64_T,
+                    communicator);
+
+      std::ranges::sort(medians);
+
+      const i64 total_size = std::accumulate(begin(medians), end(medians), i64{0},
+                                             [](i64 sum, const auto& m) { return sum + m[1]; });
+
+      // The first median at which half of the elements have been accounted for.
+      i64 covered = 0;
+      for (const auto& [median, size] : medians)
+      {
+         covered += size;
+         if (2 * covered >= total_size)
+         {
+            return static_cast<i32>(median);
+         }
+      }
+
+      return 0;
+   }
+} // namespace
+
+auto choose_pivot(pivot_rule rule, std::span<i32> local, std::mt19937_64& engine,
+                  MPI_Comm communicator) -> i32
+{
+   switch (rule)
+   {
+      case pivot_rule::mean:
+         return mean_pivot(local, communicator);
+      case pivot_rule::sample_median:
+         return sample_median_pivot(local, engine, communicator);
+      case pivot_rule::weighted_median:
+      {
+         const auto median = begin(local) + static_cast<std::ptrdiff_t>(local.size() / 2);
+         if (not local.empty())
+         {
+            std::nth_element(begin(local), median, end(local));
+         }
+
+         return weighted_median_pivot(local.empty() ? 0 : *median, local.size(), communicator);
+      }
+   }
+
+   return 0;
+}
+
+auto choose_pivot_of_sorted(pivot_rule rule, std::span<const i32> local, std::mt19937_64& engine,
+                            MPI_Comm communicator) -> i32
+{
+   switch (rule)
+   {
+      case pivot_rule::mean:
+         return mean_pivot(local, communicator);
+      case pivot_rule::sample_median:
+         return sample_median_pivot(local, engine, communicator);
+      case pivot_rule::weighted_median:
+         return weighted_median_pivot(local.empty() ? 0 : local[local.size() / 2], local.size(),
+                                      communicator);
+   }
+
+   return 0;
+}
+
+auto load_imbalance(std::size_t local_size, MPI_Comm communicator) -> f64
+{
+   int rank_count = 0;
+   MPI_Comm_size(communicator, &rank_count);
+
+   const u64 size = local_size;
+   u64 largest = 0;
+   u64 total = 0;
+   MPI_Allreduce(&size, &largest, 1, MPI_UINT64_T, MPI_MAX, communicator);
+   MPI_Allreduce(&size, &total, 1, MPI_UINT64_T, MPI_SUM, communicator);
+
+   if (total == 0)
+   {
+      return 1.0;
+   }
+
+   return static_cast<f64>(largest) * rank_count / static_cast<f64>(total);
+}
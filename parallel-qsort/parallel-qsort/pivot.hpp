@@ -0,0 +1,43 @@
+#ifndef PARALLEL_QSORT_PIVOT_HPP_
+#define PARALLEL_QSORT_PIVOT_HPP_
+
+#include <parallel-qsort/types.hpp>
+
+#include <random>
+#include <span>
+
+#include <mpi.h>
+
+// Elements drawn from each rank by pivot_rule::sample_median.
+inline constexpr u32 pivot_sample_size = 64;
+
+enum class pivot_rule
+{
+   mean,            // mean of all the elements, poor on skewed inputs
+   sample_median,   // median of a random sample drawn on every rank
+   weighted_median  // median of the per-rank medians, weighted by the rank sizes
+};
+
+/**
+ * Chooses the pivot splitting the elements of every rank of `communicator` into a low half,
+ * smaller than the pivot, and a high half. Collective: every rank gets the same pivot. The
+ * weighted median reorders `local` around its median, the other rules leave it as it is.
+ */
+auto choose_pivot(pivot_rule rule, std::span<i32> local, std::mt19937_64& engine,
+                  MPI_Comm communicator) -> i32;
+
+/**
+ * choose_pivot() for local arrays that are already sorted, which it leaves untouched and whose
+ * median it reads in O(1).
+ */
+auto choose_pivot_of_sorted(pivot_rule rule, std::span<const i32> local, std::mt19937_64& engine,
+                            MPI_Comm communicator) -> i32;
+
+/**
+ * Size of the largest local array over the mean size, across `communicator`. The slowest rank
+ * holds the largest array, so this bounds the parallel efficiency of the rest of the sort.
+ * Collective.
+ */
+auto load_imbalance(std::size_t local_size, MPI_Comm communicator) -> f64;
+
+#endif // PARALLEL_QSORT_PIVOT_HPP_
@@ -0,0 +1,62 @@
+#ifndef PARALLEL_QSORT_RECORD_HPP_
+#define PARALLEL_QSORT_RECORD_HPP_
+
+#include <parallel-qsort/mpi_type.hpp>
+#include <parallel-qsort/types.hpp>
+
+#include <array>
+#include <cstddef>
+
+#include <mpi.h>
+
+// A sort key and the opaque payload that travels with it.
+template <std::size_t PayloadSize>
+struct record
+{
+   i32 key;
+   std::array<std::byte, PayloadSize> payload;
+};
+
+struct record_key
+{
+   template <std::size_t PayloadSize>
+   constexpr auto operator()(const record<PayloadSize>& value) const noexcept -> i32
+   {
+      return value.key;
+   }
+};
+
+/**
+ * Records are described field by field, the key as an MPI_INT32_T and the payload as bytes,
+ * resized to the padded size of the record so that arrays of them are contiguous.
+ */
+template <std::size_t PayloadSize>
+struct mpi_type<record<PayloadSize>>
+{
+   static auto get() -> MPI_Datatype
+   {
+      static const MPI_Datatype type = [] {
+         using value_type = record<PayloadSize>;
+
+         const std::array<int, 2> lengths = {1, static_cast<int>(PayloadSize)};
+         const std::array<MPI_Aint, 2> displacements = {
+            static_cast<MPI_Aint>(offsetof(value_type, key)),
+            static_cast<MPI_Aint>(offsetof(value_type, payload))};
+         const std::array<MPI_Datatype, 2> types = {MPI_INT32_T, MPI_BYTE};
+
+         MPI_Datatype fields = MPI_DATATYPE_NULL;
+         MPI_Type_create_struct(2, lengths.data(), displacements.data(), types.data(), &fields);
+
+         MPI_Datatype padded = MPI_DATATYPE_NULL;
+         MPI_Type_create_resized(fields, 0, sizeof(value_type), &padded);
+         MPI_Type_commit(&padded);
+         MPI_Type_free(&fields);
+
+         return padded;
+      }();
+
+      return type;
+   }
+};
+
+#endif // PARALLEL_QSORT_RECORD_HPP_
@@ -0,0 +1,190 @@
+#ifndef PARALLEL_QSORT_SAMPLE_SORT_HPP_
+#define PARALLEL_QSORT_SAMPLE_SORT_HPP_
+
+#include <parallel-qsort/log.hpp>
+#include <parallel-qsort/mpi_type.hpp>
+#include <parallel-qsort/pivot.hpp>
+#include <parallel-qsort/trace.hpp>
+#include <parallel-qsort/types.hpp>
+
+#include <libqsort/local_sort.hpp>
+#include <libqsort/work_stealing_pool.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include <mpi.h>
+
+namespace detail
+{
+   // All-gathers the values of every rank, in rank order.
+   template <typename T>
+   auto all_gather(std::span<const T> local, MPI_Comm communicator) -> std::vector<T>
+   {
+      int rank_count = 0;
+      MPI_Comm_size(communicator, &rank_count);
+
+      const int local_size = static_cast<int>(local.size());
+      auto sizes = std::vector<int>(rank_count);
+      MPI_Allgather(&local_size, 1, MPI_INT, sizes.data(), 1, MPI_INT, communicator);
+
+      auto displacements = std::vector<int>(rank_count, 0);
+      std::exclusive_scan(begin(sizes), end(sizes), begin(displacements), 0);
+
+      auto values = std::vector<T>(displacements.back() + sizes.back());
+      MPI_Allgatherv(local.data(), local_size, mpi_datatype<T>(), values.data(), sizes.data(),
+                     displacements.data(), mpi_datatype<T>(), communicator);
+
+      return values;
+   }
+
+   /**
+    * Merges the sorted runs of `values` delimited by `bounds` pairwise, log2(runs) passes of
+    * sequential reads and writes between `values` and a scratch buffer of the same size.
+    */
+   template <typename T, typename Compare>
+   void merge_runs(std::vector<T>& values, std::vector<int> bounds, Compare comp)
+   {
+      auto scratch = std::vector<T>(values.size());
+
+      while (bounds.size() > 2)
+      {
+         std::vector<int> merged_bounds = {0};
+         for (std::size_t run = 0; run + 1 < bounds.size(); run += 2)
+         {
+            const auto first = begin(values) + bounds[run];
+            const auto middle = begin(values) + bounds[run + 1];
+            const auto last = run + 2 < bounds.size() ? begin(values) + bounds[run + 2] : middle;
+
+            std::merge(first, middle, middle, last, begin(scratch) + bounds[run], comp);
+            merged_bounds.push_back(static_cast<int>(std::distance(begin(values), last)));
+         }
+
+         values.swap(scratch);
+         bounds = std::move(merged_bounds);
+      }
+   }
+} // namespace detail
+
+/**
+ * Sorts the elements spread over the ranks of `communicator`, of any size, by parallel sorting by
+ * regular sampling: every rank sorts its array on `pool` and contributes p evenly spaced samples,
+ * the p - 1 splitters are drawn evenly from the sorted samples, one all-to-all exchange sends
+ * every element to the rank owning its interval, and each rank merges the p sorted runs it
+ * received. On return the local arrays are sorted and in rank order.
+ *
+ * Elements are ordered by the keys `key` extracts and exchanged as mpi_datatype<T>(); only the
+ * keys are sampled and gathered.
+ */
+template <typename T, typename Key = std::identity>
+void sample_sort(std::vector<T>& local_array, work_stealing_pool& pool, MPI_Comm communicator,
+                 Key key = {})
+{
+   using key_type = std::remove_cvref_t<std::invoke_result_t<Key&, const T&>>;
+
+   int process_id = 0;
+   int process_count = 0;
+   MPI_Comm_rank(communicator, &process_id);
+   MPI_Comm_size(communicator, &process_count);
+
+   {
+      const scoped_phase timer(phase::local_sort);
+      local_sort(pool, begin(local_array), end(local_array), key);
+   }
+
+   if (process_count == 1)
+   {
+      return;
+   }
+
+   scoped_phase pivot_timer(phase::pivot);
+
+   // p regular samples of the sorted local array.
+   std::vector<key_type> sample;
+   if (not local_array.empty())
+   {
+      sample.reserve(process_count);
+      for (int i = 0; i < process_count; ++i)
+      {
+         sample.push_back(std::invoke(key, local_array[i * local_array.size() / process_count]));
+      }
+   }
+
+   auto samples = detail::all_gather<key_type>(sample, communicator);
+   std::ranges::sort(samples);
+
+   // Rank r receives the elements in (splitters[r - 1], splitters[r]].
+   std::vector<key_type> splitters;
+   if (not samples.empty())
+   {
+      splitters.reserve(process_count - 1);
+      for (int r = 1; r < process_count; ++r)
+      {
+         splitters.push_back(samples[r * samples.size() / process_count]);
+      }
+   }
+
+   pivot_timer.finish();
+
+   scoped_phase partition_timer(phase::partition);
+
+   auto send_counts = std::vector<int>(process_count, 0);
+   auto send_displacements = std::vector<int>(process_count, 0);
+
+   auto bucket_begin = begin(local_array);
+   for (int r = 0; r < process_count; ++r)
+   {
+      const auto bucket_end = r + 1 < process_count and not splitters.empty()
+         ? std::ranges::upper_bound(bucket_begin, end(local_array), splitters[r], {}, key)
+         : end(local_array);
+
+      send_displacements[r] = static_cast<int>(std::distance(begin(local_array), bucket_begin));
+      send_counts[r] = static_cast<int>(std::distance(bucket_begin, bucket_end));
+
+      bucket_begin = bucket_end;
+   }
+
+   partition_timer.finish();
+
+   scoped_phase exchange_timer(phase::exchange);
+   exchange_timer.add_bytes((local_array.size() - send_counts[process_id]) * sizeof(T));
+
+   auto receive_counts = std::vector<int>(process_count, 0);
+   MPI_Alltoall(send_counts.data(), 1, MPI_INT, receive_counts.data(), 1, MPI_INT, communicator);
+
+   // The bounds of the received runs, one per rank.
+   auto receive_bounds = std::vector<int>(process_count + 1, 0);
+   std::inclusive_scan(begin(receive_counts), end(receive_counts),
+                       std::next(begin(receive_bounds)));
+
+   auto received = std::vector<T>(receive_bounds.back());
+   MPI_Alltoallv(local_array.data(), send_counts.data(), send_displacements.data(),
+                 mpi_datatype<T>(), received.data(), receive_counts.data(), receive_bounds.data(),
+                 mpi_datatype<T>(), communicator);
+
+   exchange_timer.finish();
+
+   const scoped_phase merge_timer(phase::merge);
+
+   detail::merge_runs(received, std::move(receive_bounds), [key](const T& lhs, const T& rhs) {
+      return std::invoke(key, lhs) < std::invoke(key, rhs);
+   });
+   local_array = std::move(received);
+
+   if constexpr (verbose_logging)
+   {
+      const f64 imbalance = load_imbalance(local_array.size(), communicator);
+      if (process_id == 0)
+      {
+         std::cout << "exchange - imbalance: " << imbalance << '\n';
+      }
+   }
+}
+
+#endif // PARALLEL_QSORT_SAMPLE_SORT_HPP_
@@ -0,0 +1,31 @@
+#ifndef PARALLEL_QSORT_SEEDING_HPP_
+#define PARALLEL_QSORT_SEEDING_HPP_
+
+#include <parallel-qsort/types.hpp>
+
+#include <initializer_list>
+#include <random>
+#include <vector>
+
+/**
+ * Seeds an `Engine` from `values`, typically the job seed followed by the rank or the run.
+ * std::seed_seq keeps only the low 32 bits of every value it is given, so each one goes in as its
+ * two halves, and seeds differing in their high bits draw different streams.
+ */
+template <typename Engine>
+auto seeded_engine(std::initializer_list<u64> values) -> Engine
+{
+   std::vector<u32> words;
+   words.reserve(2 * values.size());
+   for (const u64 value : values)
+   {
+      words.push_back(static_cast<u32>(value));
+      words.push_back(static_cast<u32>(value >> 32));
+   }
+
+   std::seed_seq sequence(words.begin(), words.end());
+
+   return Engine(sequence);
+}
+
+#endif // PARALLEL_QSORT_SEEDING_HPP_
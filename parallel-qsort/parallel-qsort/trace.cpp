@@ -0,0 +1,242 @@
+#include <parallel-qsort/trace.hpp>
+
+#include <parallel-qsort/mpi_type.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+namespace
+{
+   auto index(phase kind) noexcept -> std::size_t
+   {
+      return static_cast<std::size_t>(kind);
+   }
+} // namespace
+
+auto phase_name(phase kind) -> std::string_view
+{
+   switch (kind)
+   {
+      case phase::distribute:
+         return "distribute";
+      case phase::pivot:
+         return "pivot";
+      case phase::partition:
+         return "partition";
+      case phase::exchange:
+         return "exchange";
+      case phase::merge:
+         return "merge";
+      case phase::comm_split:
+         return "comm split";
+      case phase::local_sort:
+         return "local sort";
+      case phase::gather:
+         return "gather";
+   }
+
+   return "unknown";
+}
+
+void phase_trace::start(MPI_Comm communicator)
+{
+   MPI_Barrier(communicator);
+   m_origin = MPI_Wtime();
+}
+
+void phase_trace::record(phase kind, i32 round, f64 begin, f64 end, u64 bytes) noexcept
+{
+   m_ring[m_recorded % trace_capacity] = {kind, round, begin - m_origin, end - begin, bytes};
+   ++m_recorded;
+
+   m_seconds[index(kind)] += end - begin;
+   m_bytes[index(kind)] += bytes;
+   ++m_counts[index(kind)];
+}
+
+auto phase_trace::events() const -> std::vector<trace_event>
+{
+   const u64 kept = std::min<u64>(m_recorded, trace_capacity);
+
+   std::vector<trace_event> result;
+   result.reserve(kept);
+   for (u64 i = m_recorded - kept; i < m_recorded; ++i)
+   {
+      result.push_back(m_ring[i % trace_capacity]);
+   }
+
+   return result;
+}
+
+auto phase_trace::seconds(phase kind) const noexcept -> f64
+{
+   return m_seconds[index(kind)];
+}
+auto phase_trace::bytes(phase kind) const noexcept -> u64
+{
+   return m_bytes[index(kind)];
+}
+auto phase_trace::count(phase kind) const noexcept -> u64
+{
+   return m_counts[index(kind)];
+}
+
+auto rank_trace() -> phase_trace&
+{
+   static phase_trace trace;
+
+   return trace;
+}
+
+scoped_phase::scoped_phase(phase kind, i32 round) noexcept :
+   m_kind(kind), m_round(round), m_begin(MPI_Wtime())
+{}
+scoped_phase::~scoped_phase()
+{
+   finish();
+}
+
+void scoped_phase::add_bytes(u64 bytes) noexcept
+{
+   m_bytes += bytes;
+}
+
+void scoped_phase::finish() noexcept
+{
+   if (not m_finished)
+   {
+      rank_trace().record(m_kind, m_round, m_begin, MPI_Wtime(), m_bytes);
+      m_finished = true;
+   }
+}
+
+void print_phase_report(MPI_Comm communicator)
+{
+   int process_id = 0;
+   int process_count = 0;
+   MPI_Comm_rank(communicator, &process_id);
+   MPI_Comm_size(communicator, &process_count);
+
+   const auto& trace = rank_trace();
+
+   std::array<f64, phase_count> seconds = {};
+   std::array<f64, phase_count> bytes = {};
+   std::array<u64, phase_count> counts = {};
+   for (std::size_t i = 0; i < phase_count; ++i)
+   {
+      seconds[i] = trace.seconds(static_cast<phase>(i));
+      bytes[i] = static_cast<f64>(trace.bytes(static_cast<phase>(i)));
+      counts[i] = trace.count(static_cast<phase>(i));
+   }
+
+   std::array<f64, phase_count> min_seconds = {};
+   std::array<f64, phase_count> max_seconds = {};
+   std::array<f64, phase_count> total_seconds = {};
+   std::array<f64, phase_count> total_bytes = {};
+   std::array<u64, phase_count> total_counts = {};
+   MPI_Reduce(seconds.data(), min_seconds.data(), phase_count, MPI_DOUBLE, MPI_MIN, 0,
+              communicator);
+   MPI_Reduce(seconds.data(), max_seconds.data(), phase_count, MPI_DOUBLE, MPI_MAX, 0,
+              communicator);
+   MPI_Reduce(seconds.data(), total_seconds.data(), phase_count, MPI_DOUBLE, MPI_SUM, 0,
+              communicator);
+   MPI_Reduce(bytes.data(), total_bytes.data(), phase_count, MPI_DOUBLE, MPI_SUM, 0,
+              communicator);
+   MPI_Reduce(counts.data(), total_counts.data(), phase_count, MPI_UINT64_T, MPI_SUM, 0,
+              communicator);
+
+   if (process_id != 0)
+   {
+      return;
+   }
+
+   std::cout << std::left << std::setw(12) << "phase" << std::right << std::setw(12) << "min (s)"
+             << std::setw(12) << "avg (s)" << std::setw(12) << "max (s)" << std::setw(12)
+             << "imbalance" << std::setw(14) << "avg bytes" << '\n';
+
+   const auto flags = std::cout.flags();
+   const auto precision = std::cout.precision();
+   for (std::size_t i = 0; i < phase_count; ++i)
+   {
+      if (total_counts[i] == 0)
+      {
+         continue;
+      }
+
+      const f64 mean = total_seconds[i] / process_count;
+      const f64 imbalance = mean > 0.0 ? max_seconds[i] / mean : 1.0;
+
+      std::cout << std::left << std::setw(12) << phase_name(static_cast<phase>(i)) << std::right
+                << std::fixed << std::setprecision(6) << std::setw(12) << min_seconds[i]
+                << std::setw(12) << mean << std::setw(12) << max_seconds[i]
+                << std::setprecision(3) << std::setw(12) << imbalance << std::setprecision(0)
+                << std::setw(14) << total_bytes[i] / process_count << '\n';
+   }
+   std::cout.flags(flags);
+   std::cout.precision(precision);
+}
+
+auto write_chrome_trace(const std::filesystem::path& path, MPI_Comm communicator)
+   -> std::expected<void, std::string>
+{
+   int process_id = 0;
+   int process_count = 0;
+   MPI_Comm_rank(communicator, &process_id);
+   MPI_Comm_size(communicator, &process_count);
+
+   const auto events = rank_trace().events();
+   const int event_count = static_cast<int>(events.size());
+
+   auto counts = std::vector<int>(process_count, 0);
+   MPI_Gather(&event_count, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, communicator);
+
+   auto displacements = std::vector<int>(process_count, 0);
+   std::exclusive_scan(begin(counts), end(counts), begin(displacements), 0);
+
+   std::vector<trace_event> all_events;
+   if (process_id == 0)
+   {
+      all_events.resize(displacements.back() + counts.back());
+   }
+
+   MPI_Gatherv(events.data(), event_count, mpi_datatype<trace_event>(), all_events.data(),
+               counts.data(), displacements.data(), mpi_datatype<trace_event>(), 0,
+               communicator);
+
+   int written = 1;
+   if (process_id == 0)
+   {
+      auto file = std::ofstream(path);
+      file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+
+      for (int rank = 0; rank < process_count; ++rank)
+      {
+         for (int i = displacements[rank]; i < displacements[rank] + counts[rank]; ++i)
+         {
+            const auto& event = all_events[i];
+
+            file << (i == 0 ? "\n" : ",\n") << "{\"name\":\"" << phase_name(event.kind)
+                 << "\",\"ph\":\"X\",\"pid\":" << rank << ",\"tid\":0,\"ts\":"
+                 << event.begin * 1e6 << ",\"dur\":" << event.duration * 1e6
+                 << ",\"args\":{\"round\":" << event.round << ",\"bytes\":" << event.bytes
+                 << "}}";
+         }
+      }
+
+      file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+      file.close();
+
+      written = file ? 1 : 0;
+   }
+
+   MPI_Bcast(&written, 1, MPI_INT, 0, communicator);
+   if (written == 0)
+   {
+      return std::unexpected("cannot write " + path.string());
+   }
+
+   return {};
+}
@@ -0,0 +1,112 @@
+#ifndef PARALLEL_QSORT_TRACE_HPP_
+#define PARALLEL_QSORT_TRACE_HPP_
+
+#include <parallel-qsort/types.hpp>
+
+#include <array>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <mpi.h>
+
+enum class phase : u32
+{
+   distribute, // input scattered from rank 0 or read from the input file
+   pivot,      // pivot or splitter selection, collective
+   partition,  // local split of the array around the pivot or splitters
+   exchange,   // elements moved between ranks
+   merge,      // merge of sorted runs received from other ranks
+   comm_split, // communicator split into sub-cubes
+   local_sort, // local sort on the thread pool
+   gather      // output gathered to rank 0 or written to the output file
+};
+
+inline constexpr std::size_t phase_count = 8;
+
+auto phase_name(phase kind) -> std::string_view;
+
+struct trace_event
+{
+   phase kind;
+   i32 round;    // round of the sort, -1 outside of the rounds
+   f64 begin;    // seconds since phase_trace::start()
+   f64 duration; // seconds
+   u64 bytes;    // bytes sent by this rank
+};
+
+// Events kept per rank for the timeline, the oldest ones are overwritten first.
+inline constexpr std::size_t trace_capacity = 4096;
+
+/**
+ * The phases of this rank: a ring buffer of the last `trace_capacity` events for the timeline,
+ * and running totals per phase that cover every event.
+ */
+class phase_trace
+{
+public:
+   // Synchronizes the ranks of `communicator` and makes now the origin of the timeline.
+   void start(MPI_Comm communicator);
+
+   void record(phase kind, i32 round, f64 begin, f64 end, u64 bytes) noexcept;
+
+   // The recorded events still in the ring buffer, oldest first.
+   [[nodiscard]] auto events() const -> std::vector<trace_event>;
+
+   [[nodiscard]] auto seconds(phase kind) const noexcept -> f64;
+   [[nodiscard]] auto bytes(phase kind) const noexcept -> u64;
+   [[nodiscard]] auto count(phase kind) const noexcept -> u64;
+
+private:
+   f64 m_origin = 0.0;
+
+   std::array<trace_event, trace_capacity> m_ring = {};
+   u64 m_recorded = 0;
+
+   std::array<f64, phase_count> m_seconds = {};
+   std::array<u64, phase_count> m_bytes = {};
+   std::array<u64, phase_count> m_counts = {};
+};
+
+// The trace of this process, which is one rank.
+auto rank_trace() -> phase_trace&;
+
+// Records the lifetime of the scope, or up to finish(), as one event of `kind` in rank_trace().
+class scoped_phase
+{
+public:
+   explicit scoped_phase(phase kind, i32 round = -1) noexcept;
+   ~scoped_phase();
+
+   scoped_phase(const scoped_phase&) = delete;
+   auto operator=(const scoped_phase&) -> scoped_phase& = delete;
+
+   void add_bytes(u64 bytes) noexcept;
+
+   // Ends the event before the end of the scope.
+   void finish() noexcept;
+
+private:
+   phase m_kind;
+   i32 m_round;
+   f64 m_begin;
+   u64 m_bytes = 0;
+   bool m_finished = false;
+};
+
+/**
+ * Reduces the phase totals of every rank of `communicator`, which rank 0 prints as the min, mean
+ * and max time per phase, the imbalance max / mean and the mean bytes sent. Collective.
+ */
+void print_phase_report(MPI_Comm communicator);
+
+/**
+ * Gathers the events of every rank of `communicator` on rank 0, which writes them to `path` in
+ * the Chrome trace event format, one process per rank. Collective, every rank gets the result.
+ */
+auto write_chrome_trace(const std::filesystem::path& path, MPI_Comm communicator)
+   -> std::expected<void, std::string>;
+
+#endif // PARALLEL_QSORT_TRACE_HPP_
@@ -0,0 +1,114 @@
+#include <sequential-floyd-warshall/distance_matrix.hpp>
+
+#include <algorithm>
+
+distance_matrix::distance_matrix(u32 vertex_count, u32 padding) :
+   m_vertex_count(vertex_count), m_stride((vertex_count + padding - 1) / padding * padding),
+   m_distances(std::make_unique_for_overwrite<i32[]>(std::size_t{m_stride} * m_stride))
+{
+   clear_rows(0, m_stride);
+}
+
+distance_matrix::distance_matrix(u32 vertex_count, u32 padding, thread_team& team) :
+   m_vertex_count(vertex_count), m_stride((vertex_count + padding - 1) / padding * padding),
+   m_distances(std::make_unique_for_overwrite<i32[]>(std::size_t{m_stride} * m_stride))
+{
+   const u32 block_count = m_stride / padding;
+
+   team.run([&](u32 member) {
+      for (u32 block = member; block < block_count; block += team.size())
+      {
+         clear_rows(block * padding, (block + 1) * padding);
+      }
+   });
+}
+
+auto distance_matrix::vertex_count() const noexcept -> u32
+{
+   return m_vertex_count;
+}
+auto distance_matrix::stride() const noexcept -> u32
+{
+   return m_stride;
+}
+
+auto distance_matrix::data() noexcept -> i32*
+{
+   return m_distances.get();
+}
+auto distance_matrix::data() const noexcept -> const i32*
+{
+   return m_distances.get();
+}
+
+auto distance_matrix::same_distances(const distance_matrix& other) const noexcept -> bool
+{
+   if (m_vertex_count != other.m_vertex_count)
+   {
+      return false;
+   }
+
+   for (u32 i = 0; i < m_vertex_count; ++i)
+   {
+      const i32* row = data() + std::size_t{i} * m_stride;
+      const i32* other_row = other.data() + std::size_t{i} * other.m_stride;
+      const auto same = [](i32 lhs, i32 rhs) {
+         return lhs == rhs or (not reachable(lhs) and not reachable(rhs));
+      };
+      if (not std::equal(row, row + m_vertex_count, other_row, same))
+      {
+         return false;
+      }
+   }
+
+   return true;
+}
+
+void distance_matrix::clear_rows(u32 first, u32 last) noexcept
+{
+   for (u32 i = first; i < last; ++i)
+   {
+      i32* row = data() + std::size_t{i} * m_stride;
+      std::fill(row, row + m_stride, tombstone);
+      row[i] = 0;
+   }
+}
+
+auto create_adjacency_matrix(const graph& g, u32 padding)
+   -> std::expected<distance_matrix, std::string>
+{
+   auto dist = distance_matrix(static_cast<u32>(g.size()), padding);
+   const i32 max_weight = max_edge_weight(dist.vertex_count());
+
+   for (const auto& n : g)
+   {
+      for (const auto& e : n.edges)
+      {
+         if (e.weight > max_weight or e.weight < -max_weight)
+         {
+            return std::unexpected("the weight " + std::to_string(e.weight) + " of an edge of " +
+                                   std::to_string(n.index) + " is beyond " +
+                                   std::to_string(max_weight) + " for " +
+                                   std::to_string(dist.vertex_count()) + " vertices");
+         }
+
+         dist(n.index, e.end) = e.weight;
+      }
+   }
+
+   return dist;
+}
+
+void add_random_edges(distance_matrix& dist, u32 edges_per_vertex, u64 seed)
+{
+   add_random_edges(dist.data(), dist.stride(), dist.vertex_count(), edges_per_vertex, seed);
+}
+
+auto create_random_matrix(u32 vertex_count, u32 edges_per_vertex, u64 seed, u32 padding)
+   -> distance_matrix
+{
+   auto dist = distance_matrix(vertex_count, padding);
+   add_random_edges(dist, edges_per_vertex, seed);
+
+   return dist;
+}
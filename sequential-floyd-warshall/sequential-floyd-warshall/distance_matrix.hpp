@@ -0,0 +1,77 @@
+#ifndef SEQUENTIAL_FLOYD_WARSHALL_DISTANCE_MATRIX_HPP_
+#define SEQUENTIAL_FLOYD_WARSHALL_DISTANCE_MATRIX_HPP_
+
+#include <sequential-floyd-warshall/graph/graph.hpp>
+#include <sequential-floyd-warshall/types.hpp>
+
+#include <libfloyd-warshall/distance.hpp>
+#include <libfloyd-warshall/random_graph.hpp>
+#include <libfloyd-warshall/thread_team.hpp>
+
+#include <cstddef>
+#include <expected>
+#include <memory>
+#include <string>
+
+/**
+ * Square matrix of the distances between `vertex_count` vertices, row-major in one contiguous
+ * buffer. The rows are padded to a multiple of `padding` with isolated vertices, so that blocked
+ * kernels only ever work on whole tiles.
+ */
+class distance_matrix
+{
+public:
+   explicit distance_matrix(u32 vertex_count, u32 padding = 1);
+
+   /**
+    * The rows are first written by the members of `team`, the b-th block of `padding` rows by
+    * member b % team.size(), which places them on the NUMA node of the member that later relaxes
+    * them in blocked_floyd_warshall().
+    */
+   distance_matrix(u32 vertex_count, u32 padding, thread_team& team);
+
+   auto vertex_count() const noexcept -> u32;
+
+   // Elements from the start of a row to the start of the next, at least vertex_count().
+   auto stride() const noexcept -> u32;
+
+   auto data() noexcept -> i32*;
+   auto data() const noexcept -> const i32*;
+
+   auto operator()(u32 i, u32 j) noexcept -> i32&
+   {
+      return m_distances[std::size_t{i} * m_stride + j];
+   }
+   auto operator()(u32 i, u32 j) const noexcept -> i32
+   {
+      return m_distances[std::size_t{i} * m_stride + j];
+   }
+
+   // Whether both hold the same distances between their vertices, whatever their padding and
+   // however far under the tombstone their unreachable distances ended.
+   auto same_distances(const distance_matrix& other) const noexcept -> bool;
+
+private:
+   // Sets the rows of [first, last) to the distances of isolated vertices.
+   void clear_rows(u32 first, u32 last) noexcept;
+
+private:
+   u32 m_vertex_count;
+   u32 m_stride;
+
+   // Left uninitialized on allocation so that its pages are placed by the first thread to write.
+   std::unique_ptr<i32[]> m_distances;
+};
+
+// Fails if a weight of `g` is beyond max_edge_weight(), whose distances the kernels cannot solve.
+auto create_adjacency_matrix(const graph& g, u32 padding = 1)
+   -> std::expected<distance_matrix, std::string>;
+
+// Adds `edges_per_vertex` edges of weight 1 to max_random_weight leaving each vertex of `dist`,
+// which must have at most max_random_vertex_count vertices.
+void add_random_edges(distance_matrix& dist, u32 edges_per_vertex, u64 seed);
+
+auto create_random_matrix(u32 vertex_count, u32 edges_per_vertex, u64 seed, u32 padding = 1)
+   -> distance_matrix;
+
+#endif // SEQUENTIAL_FLOYD_WARSHALL_DISTANCE_MATRIX_HPP_
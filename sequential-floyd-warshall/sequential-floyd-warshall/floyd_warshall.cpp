@@ -0,0 +1,111 @@
+#include <sequential-floyd-warshall/floyd_warshall.hpp>
+
+#include <libfloyd-warshall/min_plus.hpp>
+
+#include <algorithm>
+#include <cstddef>
+
+namespace
+{
+   /**
+    * Relaxes the tile at rows `i0` and columns `j0` through the vertices of the tile at `k0`,
+    * reading the tiles (i0, k0) and (k0, j0). With k outermost this stays exact when the updated
+    * tile is one of the two it reads.
+    */
+   void relax_tile(i32* dist, u32 stride, u32 i0, u32 j0, u32 k0)
+   {
+      for (u32 k = k0; k < k0 + floyd_warshall_tile; ++k)
+      {
+         const i32* row_k = dist + std::size_t{k} * stride;
+
+         for (u32 i = i0; i < i0 + floyd_warshall_tile; ++i)
+         {
+            i32* row_i = dist + std::size_t{i} * stride;
+
+            // Once per row rather than per element, which keeps sparse graphs cheap.
+            if (reachable(row_i[k]))
+            {
+               min_plus_row(row_i + j0, row_k + j0, row_i[k], floyd_warshall_tile);
+            }
+         }
+      }
+   }
+} // namespace
+
+void floyd_warshall(distance_matrix& dist)
+{
+   const u32 n = dist.vertex_count();
+
+   for (u32 k = 0; k < n; ++k)
+   {
+      for (u32 i = 0; i < n; ++i)
+      {
+         const i32 ik = dist(i, k);
+         if (ik == tombstone)
+         {
+            continue;
+         }
+
+         for (u32 j = 0; j < n; ++j)
+         {
+            if (dist(k, j) != tombstone)
+            {
+               dist(i, j) = std::min(ik + dist(k, j), dist(i, j));
+            }
+         }
+      }
+   }
+}
+
+void blocked_floyd_warshall(distance_matrix& dist)
+{
+   auto team = thread_team(1);
+   blocked_floyd_warshall(dist, team);
+}
+
+void blocked_floyd_warshall(distance_matrix& dist, thread_team& team)
+{
+   const u32 stride = dist.stride();
+   const u32 tile_count = stride / floyd_warshall_tile;
+   const u32 member_count = team.size();
+
+   i32* data = dist.data();
+
+   team.run([&](u32 member) {
+      for (u32 kt = 0; kt < tile_count; ++kt)
+      {
+         const u32 k0 = kt * floyd_warshall_tile;
+
+         // The diagonal tile was last relaxed by its own member, no need to wait for the others
+         // to finish the previous round, which never touch it.
+         if (kt % member_count == member)
+         {
+            relax_tile(data, stride, k0, k0, k0);
+         }
+
+         team.sync();
+
+         for (u32 t = member; t < tile_count; t += member_count)
+         {
+            if (t != kt)
+            {
+               relax_tile(data, stride, k0, t * floyd_warshall_tile, k0);
+               relax_tile(data, stride, t * floyd_warshall_tile, k0, k0);
+            }
+         }
+
+         team.sync();
+
+         for (u32 it = member; it < tile_count; it += member_count)
+         {
+            for (u32 jt = 0; jt < tile_count; ++jt)
+            {
+               if (it != kt and jt != kt)
+               {
+                  relax_tile(data, stride, it * floyd_warshall_tile, jt * floyd_warshall_tile, k0);
+               }
+            }
+         }
+      }
+   });
+}
@@ -0,0 +1,36 @@
+#ifndef SEQUENTIAL_FLOYD_WARSHALL_FLOYD_WARSHALL_HPP_
+#define SEQUENTIAL_FLOYD_WARSHALL_FLOYD_WARSHALL_HPP_
+
+#include <sequential-floyd-warshall/distance_matrix.hpp>
+#include <sequential-floyd-warshall/types.hpp>
+
+#include <libfloyd-warshall/thread_team.hpp>
+
+// Tile edge of blocked_floyd_warshall(). A 64 x 64 tile of i32 is 16 KiB: the row of the pivot
+// tile read by an update stays in L1 and the three tiles of an update fit in L2.
+inline constexpr u32 floyd_warshall_tile = 64;
+
+// The textbook algorithm, the k-th row and column relaxing the whole matrix for every k. Scalar,
+// as the reference for the other kernels.
+void floyd_warshall(distance_matrix& dist);
+
+/**
+ * Floyd-Warshall over tiles of `floyd_warshall_tile` vertices. For each diagonal tile, the tile
+ * is first closed over its own vertices, then the tiles of its row and column panels are relaxed
+ * through it, then every other tile through the two panel tiles in line with it. Each update only
+ * touches three tiles, which stay in cache, instead of sweeping the whole matrix once per vertex,
+ * and runs through min_plus_row().
+ * `dist` must be padded to a multiple of the tile.
+ */
+void blocked_floyd_warshall(distance_matrix& dist);
+
+/**
+ * blocked_floyd_warshall() on the members of `team`. Within a round, the tiles of the two panels
+ * and then all the other tiles are independent, so they are shared out between the members, tile
+ * row r and the panel tiles in line with it going to member r % team.size(). That is the member
+ * that wrote those rows first when `dist` was built with the same team, so on a NUMA machine all
+ * but the tiles of the row panel are relaxed by a member of the node that holds them.
+ */
+void blocked_floyd_warshall(distance_matrix& dist, thread_team& team);
+
+#endif // SEQUENTIAL_FLOYD_WARSHALL_FLOYD_WARSHALL_HPP_
@@ -0,0 +1,25 @@
+#ifndef SEQUENTIAL_FLOYD_WARSHALL_OPTIONS_HPP_
+#define SEQUENTIAL_FLOYD_WARSHALL_OPTIONS_HPP_
+
+#include <sequential-floyd-warshall/types.hpp>
+
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+
+struct options
+{
+   // Solves a random graph of this many vertices with both kernels instead of the sample graph.
+   std::optional<u32> vertex_count;
+
+   u32 edges_per_vertex = 8;
+   u64 seed = 1;
+
+   // Threads of the blocked kernel, 0 starts one per available CPU.
+   u32 thread_count = 0;
+};
+
+auto parse_options(std::span<char*> args) -> std::expected<options, std::string>;
+
+#endif // SEQUENTIAL_FLOYD_WARSHALL_OPTIONS_HPP_
@@ -1,11 +1,15 @@
-#include <algorithm>
+#include <sequential-floyd-warshall/distance_matrix.hpp>
+#include <sequential-floyd-warshall/floyd_warshall.hpp>
 #include <sequential-floyd-warshall/graph/graph.hpp>
+#include <sequential-floyd-warshall/options.hpp>
 #include <sequential-floyd-warshall/types.hpp>
 
-#include <iostream>
-#include <limits>
+#include <libfloyd-warshall/min_plus.hpp>
+#include <libfloyd-warshall/thread_team.hpp>
 
-static constexpr i32 tombstone = std::numeric_limits<i32>::max();
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
 
 void print(const graph& g)
 {
@@ -23,28 +27,85 @@ void print(const graph& g)
    }
 }
 
-auto create_adjacency_matrix(const graph& g) -> std::vector<std::vector<i32>>
+void print(const distance_matrix& dist)
+{
+   for (u32 i = 0; i < dist.vertex_count(); ++i)
+   {
+      for (u32 j = 0; j < dist.vertex_count(); ++j)
+      {
+         if (not reachable(dist(i, j)))
+         {
+            std::cout << "_ ";
+         }
+         else
+         {
+            std::cout << dist(i, j) << " ";
+         }
+      }
+
+      std::cout << "\n";
+   }
+}
+
+// Seconds taken by `solve`.
+template <typename Solve>
+auto time_seconds(Solve solve) -> double
 {
-   auto dist = std::vector<std::vector<i32>>(g.size(), std::vector<i32>(g.size(), tombstone));
+   const auto start = std::chrono::steady_clock::now();
+   solve();
+   const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+   return elapsed.count();
+}
 
-   for (const auto& n : g)
+auto main(int argc, char* argv[]) -> int
+{
+   const auto opts = parse_options({argv, static_cast<std::size_t>(argc)});
+   if (not opts)
    {
-      dist[n.index][n.index] = 0;
+      std::cout << "error: " << opts.error() << '\n';
+
+      return EXIT_FAILURE;
    }
 
-   for (const auto& n : g)
+   if (opts->vertex_count)
    {
-      for (const auto& e : n.edges)
+      auto team = thread_team(opts->thread_count == 0 ? available_cpu_count() : opts->thread_count);
+
+      auto reference =
+         create_random_matrix(*opts->vertex_count, opts->edges_per_vertex, opts->seed);
+      auto blocked = distance_matrix(*opts->vertex_count, floyd_warshall_tile, team);
+      add_random_edges(blocked, opts->edges_per_vertex, opts->seed);
+
+      const double reference_seconds = time_seconds([&] {
+         floyd_warshall(reference);
+      });
+      const double blocked_seconds = time_seconds([&] {
+         blocked_floyd_warshall(blocked, team);
+      });
+
+      std::cout << "vertices: " << *opts->vertex_count << "\n";
+      std::cout << "threads: " << team.size() << "\n";
+      std::cout << "min-plus kernel: " << min_plus_kernel_name() << "\n";
+      std::cout << "floyd-warshall: " << reference_seconds << " s\n";
+      std::cout << "blocked floyd-warshall: " << blocked_seconds << " s ("
+                << reference_seconds / blocked_seconds << "x)\n";
+
+      const auto summary = summarize_distances(blocked.data(), blocked.stride(),
+                                               blocked.vertex_count());
+      std::cout << "reachable pairs: " << summary.reachable_pairs << "\n";
+      std::cout << "distance sum: " << summary.distance_sum << "\n";
+
+      if (not blocked.same_distances(reference))
       {
-         dist[n.index][e.end] = e.weight;
+         std::cout << "error: the blocked distances differ from the reference ones\n";
+
+         return EXIT_FAILURE;
       }
-   }
 
-   return dist;
-}
+      return EXIT_SUCCESS;
+   }
 
-auto main() -> int
-{
    graph g;
    g.add_connection(0, edge{-2, 2});
    g.add_connection(1, edge{4, 0});
@@ -54,59 +115,23 @@ auto main() -> int
 
    print(g);
 
-   auto dist = create_adjacency_matrix(g);
-
-   std::cout << "\nMATRIX\n";
-
-   for (const auto& row : dist)
+   auto dist = create_adjacency_matrix(g, floyd_warshall_tile);
+   if (not dist)
    {
-      for (auto j : row)
-      {
-         if (j == tombstone)
-         {
-            std::cout << "_ ";
-         }
-         else
-         {
-            std::cout << j << " ";
-         }
-      }
+      std::cout << "error: " << dist.error() << '\n';
 
-      std::cout << "\n";
+      return EXIT_FAILURE;
    }
 
-   for (int k = 0; k < g.size(); ++k)
-   {
-      for (int j = 0; j < g.size(); ++j)
-      {
-         for (int i = 0; i < g.size(); ++i)
-         {
-            if (dist[i][k] != tombstone and dist[k][j] != tombstone)
-            {
-               dist[i][j] = std::min(dist[i][k] + dist[k][j], dist[i][j]);
-            }
-         }
-      }
-   }
+   std::cout << "\nMATRIX\n";
 
-   std::cout << "\nAfter floyd-warshall\n";
+   print(*dist);
 
-   for (const auto& row : dist)
-   {
-      for (auto j : row)
-      {
-         if (j == tombstone)
-         {
-            std::cout << "_ ";
-         }
-         else
-         {
-            std::cout << j << " ";
-         }
-      }
+   blocked_floyd_warshall(*dist);
 
-      std::cout << "\n";
-   }
+   std::cout << "\nAfter floyd-warshall\n";
+
+   print(*dist);
 
    return 0;
 }
@@ -0,0 +1,115 @@
+#include <sequential-pi/options.hpp>
+
+#include <charconv>
+#include <string_view>
+
+namespace
+{
+   template <typename T>
+   auto parse_number(std::string_view name, std::string_view text) -> std::expected<T, std::string>
+   {
+      T value{};
+      const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+      if (error != std::errc() or end != text.data() + text.size())
+      {
+         return std::unexpected("invalid value '" + std::string(text) + "' for " +
+                                std::string(name));
+      }
+
+      return value;
+   }
+
+   // Parses the value following the option at `args[i]` and moves `i` past it.
+   template <typename T>
+   auto next_number(std::span<char*> args, std::size_t& i) -> std::expected<T, std::string>
+   {
+      const std::string_view name = args[i];
+      if (i + 1 >= args.size())
+      {
+         return std::unexpected("missing value for " + std::string(name));
+      }
+
+      return parse_number<T>(name, args[++i]);
+   }
+} // namespace
+
+auto parse_options(std::span<char*> args) -> std::expected<options, std::string>
+{
+   options result;
+
+   for (std::size_t i = 1; i < args.size(); ++i)
+   {
+      const std::string_view arg = args[i];
+
+      if (arg == "--seed")
+      {
+         const auto seed = next_number<u64>(args, i);
+         if (not seed)
+         {
+            return std::unexpected(seed.error());
+         }
+
+         result.seed = *seed;
+      }
+      else if (arg == "--sampler")
+      {
+         const std::string_view name = i + 1 < args.size() ? args[++i] : "";
+         if (name == "philox")
+         {
+            result.sampling = sampler::pseudo_random;
+         }
+         else if (name == "sobol")
+         {
+            result.sampling = sampler::sobol;
+         }
+         else
+         {
+            return std::unexpected("--sampler must be one of philox, sobol");
+         }
+      }
+      else if (arg == "--strata")
+      {
+         const auto strata = next_number<u64>(args, i);
+         if (not strata)
+         {
+            return std::unexpected(strata.error());
+         }
+         if (*strata == 0 or *strata > sample_count or sample_count % (*strata * *strata) != 0)
+         {
+            return std::unexpected("--strata squared must divide " + std::to_string(sample_count));
+         }
+
+         result.strata = *strata;
+      }
+      else if (arg == "--tolerance")
+      {
+         const auto tolerance = next_number<f64>(args, i);
+         if (not tolerance)
+         {
+            return std::unexpected(tolerance.error());
+         }
+         if (*tolerance <= 0.0)
+         {
+            return std::unexpected("--tolerance must be positive");
+         }
+
+         result.tolerance = *tolerance;
+      }
+      else if (arg == "--threads")
+      {
+         const auto thread_count = next_number<u32>(args, i);
+         if (not thread_count)
+         {
+            return std::unexpected(thread_count.error());
+         }
+
+         result.thread_count = *thread_count;
+      }
+      else
+      {
+         return std::unexpected("unknown option " + std::string(arg));
+      }
+   }
+
+   return result;
+}
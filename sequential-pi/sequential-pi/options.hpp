@@ -0,0 +1,38 @@
+#ifndef SEQUENTIAL_PI_OPTIONS_HPP_
+#define SEQUENTIAL_PI_OPTIONS_HPP_
+
+#include <sequential-pi/types.hpp>
+
+#include <expected>
+#include <optional>
+#include <span>
+#include <string>
+
+// Samples drawn in one batch, batch b of a seed always draws the same samples.
+inline constexpr u64 sample_count = 10000;
+
+enum class sampler
+{
+   pseudo_random, // Philox streams, one per batch
+   sobol          // contiguous slices of a scrambled Sobol sequence, one per batch
+};
+
+struct options
+{
+   std::optional<u64> seed;
+   sampler sampling = sampler::pseudo_random;
+
+   // The unit square is split into strata x strata cells sampled equally by every batch, the
+   // cell count must divide sample_count.
+   u64 strata = 1;
+
+   // Sampling stops once the 95% confidence interval of the estimate is within this of it.
+   f64 tolerance = 1e-4;
+
+   // Sampling threads, 0 starts one per available CPU.
+   u32 thread_count = 1;
+};
+
+auto parse_options(std::span<char*> args) -> std::expected<options, std::string>;
+
+#endif // SEQUENTIAL_PI_OPTIONS_HPP_
@@ -1,84 +1,87 @@
-#include <cstdint>
+#include <sequential-pi/options.hpp>
+#include <sequential-pi/types.hpp>
+
+#include <libmonte-carlo/circle_hits.hpp>
+#include <libmonte-carlo/monte_carlo.hpp>
+#include <libmonte-carlo/philox.hpp>
+#include <libmonte-carlo/running_statistics.hpp>
+#include <libmonte-carlo/sampling_team.hpp>
+
 #include <iostream>
-#include <limits>
 #include <random>
 
 #include <mpi.h>
 
-using u16 = std::uint16_t;
-using u32 = std::uint32_t;
-using u64 = std::uint64_t;
-using f64 = double;
-
-static constexpr u64 sample_count = 10000;
-static constexpr f64 circle_center = 0.5;
-static constexpr f64 circle_radius = 0.5;
-static constexpr f64 desired_pi = 3.141592;
-static constexpr f64 convergence_epsilon = 0.000001;
-
-auto is_within_circle(f64 x, f64 y) -> bool
+struct estimate
 {
-   const f64 x_dir = circle_center - x;
-   const f64 y_dir = circle_center - y;
-
-   const f64 distance_to_center = std::sqrt(x_dir * x_dir + y_dir * y_dir);
+   running_statistics statistics;
+   u32 thread_count = 1;
+};
 
-   return distance_to_center <= circle_radius;
-}
-
-auto is_converging(f64 value) -> bool
-{
-   const f64 adjusted_value = value - desired_pi;
-
-   return adjusted_value < convergence_epsilon and adjusted_value > -convergence_epsilon;
-}
+template <typename Sampler>
+auto run(const options& opts, Sampler sampler) -> estimate;
 
 auto main(int argc, char *argv[]) -> int
 {
    int process_id = 0;
    int process_count = 0;
 
-   MPI_Init(&argc, &argv);
+   int thread_support = 0;
+   MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &thread_support);
 
    const f64 start_time = MPI_Wtime();
 
    MPI_Comm_size(MPI_COMM_WORLD, &process_count);
    MPI_Comm_rank(MPI_COMM_WORLD, &process_id);
 
-   std::random_device rd;
-   auto random_engine = std::default_random_engine(rd());
-   auto distribution = std::uniform_real_distribution<f64>(circle_center - circle_radius,
-                                                           circle_center + circle_radius);
-
-   u64 iteration_count = 1;
-   u64 circle_hits = 0;
-   f64 pi = 0.0;
-   do
+   const auto opts = parse_options({argv, static_cast<std::size_t>(argc)});
+   if (not opts)
    {
-      for (u64 i = 0; i < sample_count; ++i)
-      {
-         const f64 x = distribution(random_engine);
-         const f64 y = distribution(random_engine);
-
-         if (is_within_circle(x, y))
-         {
-            ++circle_hits;
-         }
-      }
-
-      // NOLINTNEXTLINE
-      pi = 4.0f * static_cast<f64>(circle_hits) / static_cast<f64>(sample_count * iteration_count);
-      ++iteration_count;
-   } while (!is_converging(pi));
+      std::cout << "error: " << opts.error() << '\n';
+
+      MPI_Finalize();
+
+      return EXIT_FAILURE;
+   }
+
+   std::random_device rd;
+   const u64 seed = opts->seed.value_or((static_cast<u64>(rd()) << 32) | rd());
+
+   const auto result = opts->sampling == sampler::sobol
+      ? run(*opts, monte_carlo::sobol_sampler(seed, sample_count))
+      : run(*opts, monte_carlo::philox_sampler<2>(seed, sample_count));
+   const auto& statistics = result.statistics;
 
    const f64 elapsed_time = MPI_Wtime() - start_time;
 
    MPI_Finalize();
 
-   std::cout << "iteration to converge: " << iteration_count << '\n';
-   std::cout << "total samples: " << iteration_count * sample_count << '\n';
-   std::cout << "result: " << pi << '\n';
+   std::cout << "seed: " << seed << '\n';
+   std::cout << "sampler: " << (opts->sampling == sampler::sobol ? "sobol" : "philox") << '\n';
+   std::cout << "strata: " << opts->strata << 'x' << opts->strata << '\n';
+   std::cout << "threads: " << result.thread_count << '\n';
+   std::cout << "simd kernel: " << circle_hits_kernel_name() << " (rng: " << philox_kernel_name()
+             << ")\n";
+   std::cout << "iteration to converge: " << statistics.count << '\n';
+   std::cout << "total samples: " << statistics.count * sample_count << '\n';
+   std::cout << "result: " << statistics.mean << " +/- " << statistics.half_width() << '\n';
    std::cout << "elapsed time: " << elapsed_time << '\n';
 
    return EXIT_SUCCESS;
 }
+
+// One batch per thread and per round. Batches are numbered as in parallel-pi, so both programs
+// draw the same samples for a seed.
+template <typename Sampler>
+auto run(const options& opts, Sampler sampler) -> estimate
+{
+   const auto estimator = monte_carlo::estimator<2, monte_carlo::circle_indicator, Sampler,
+                                                 monte_carlo::stratified_box<2>>(
+      {}, sampler, monte_carlo::stratified_box<2>({0.0, 0.0}, {1.0, 1.0}, opts.strata),
+      sample_count);
+
+   auto team = monte_carlo::threaded_backend<decltype(estimator)>(
+      estimator, opts.thread_count == 0 ? available_cpu_count() : opts.thread_count);
+
+   return {.statistics = monte_carlo::integrate(team, opts.tolerance), .thread_count = team.size()};
+}
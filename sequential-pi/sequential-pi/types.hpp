@@ -0,0 +1,11 @@
+#ifndef SEQUENTIAL_PI_TYPES_HPP_
+#define SEQUENTIAL_PI_TYPES_HPP_
+
+#include <cstdint>
+
+using u16 = std::uint16_t;
+using u32 = std::uint32_t;
+using u64 = std::uint64_t;
+using f64 = double;
+
+#endif // SEQUENTIAL_PI_TYPES_HPP_
@@ -0,0 +1,512 @@
+#include <sequential-qsort/external_sort.hpp>
+
+#include <libqsort/local_sort.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <memory>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace
+{
+   // Smallest block of a merge stream, in elements, whatever the fan-in.
+   constexpr std::size_t min_block_size = std::size_t{1} << 14;
+
+   struct file_closer
+   {
+      void operator()(std::FILE* file) const noexcept
+      {
+         std::fclose(file);
+      }
+   };
+
+   using file_handle = std::unique_ptr<std::FILE, file_closer>;
+
+   // Left uninitialized, every block is overwritten before it is read.
+   using block_buffer = std::unique_ptr<i32[]>;
+
+   auto open_file(const std::filesystem::path& path, const char* mode)
+      -> std::expected<file_handle, std::string>
+   {
+      auto file = file_handle(std::fopen(path.c_str(), mode));
+      if (not file)
+      {
+         return std::unexpected("cannot open " + path.string() + ": " + std::strerror(errno));
+      }
+
+      // Blocks are large already, the stdio buffer would only add a copy.
+      std::setvbuf(file.get(), nullptr, _IONBF, 0);
+
+      return file;
+   }
+
+   auto seconds_since(std::chrono::steady_clock::time_point start) -> f64
+   {
+      return std::chrono::duration<f64>(std::chrono::steady_clock::now() - start).count();
+   }
+
+   /**
+    * Reads a file of i32 block after block, the next block being read on another thread while
+    * the current one is in use.
+    */
+   class block_reader
+   {
+   public:
+      block_reader(file_handle file, std::size_t block_size) :
+         m_file(std::move(file)), m_block_size(block_size),
+         m_current(std::make_unique_for_overwrite<i32[]>(block_size)),
+         m_next(std::make_unique_for_overwrite<i32[]>(block_size))
+      {
+         prefetch();
+      }
+      block_reader(const block_reader&) = delete;
+      block_reader(block_reader&&) = delete;
+      ~block_reader()
+      {
+         if (m_pending.valid())
+         {
+            m_pending.wait();
+         }
+      }
+
+      auto operator=(const block_reader&) -> block_reader& = delete;
+      auto operator=(block_reader&&) -> block_reader& = delete;
+
+      /**
+       * The next block, valid until the following call, and empty at the end of the file.
+       */
+      auto next() -> std::expected<std::span<i32>, std::string>
+      {
+         if (not m_pending.valid())
+         {
+            return std::span<i32>();
+         }
+
+         const std::size_t count = m_pending.get();
+         if (std::ferror(m_file.get()) != 0)
+         {
+            return std::unexpected("cannot read a sorted run or the input");
+         }
+
+         std::swap(m_current, m_next);
+         if (count == m_block_size)
+         {
+            prefetch();
+         }
+
+         return std::span(m_current.get(), count);
+      }
+
+   private:
+      void prefetch()
+      {
+         m_pending = std::async(std::launch::async,
+                                [file = m_file.get(), block = m_next.get(), size = m_block_size] {
+                                   return std::fread(block, sizeof(i32), size, file);
+                                });
+      }
+
+   private:
+      file_handle m_file;
+      std::size_t m_block_size;
+      block_buffer m_current;
+      block_buffer m_next;
+      std::future<std::size_t> m_pending;
+   };
+
+   /**
+    * Writes a file of i32 block after block, a full block being written on another thread while
+    * the next one fills up.
+    */
+   class block_writer
+   {
+   public:
+      block_writer(file_handle file, std::size_t block_size) :
+         m_file(std::move(file)), m_block_size(block_size),
+         m_filling(std::make_unique_for_overwrite<i32[]>(block_size)),
+         m_writing(std::make_unique_for_overwrite<i32[]>(block_size))
+      {}
+      block_writer(const block_writer&) = delete;
+      block_writer(block_writer&&) = delete;
+      ~block_writer()
+      {
+         if (m_pending.valid())
+         {
+            m_pending.wait();
+         }
+      }
+
+      auto operator=(const block_writer&) -> block_writer& = delete;
+      auto operator=(block_writer&&) -> block_writer& = delete;
+
+      auto push(i32 value) -> bool
+      {
+         m_filling[m_size++] = value;
+
+         return m_size < m_block_size or flush();
+      }
+
+      // Writes what is left and waits for the disk.
+      auto finish() -> std::expected<void, std::string>
+      {
+         if (not flush() or (m_pending.valid() and not m_pending.get()) or
+             std::fflush(m_file.get()) != 0)
+         {
+            return std::unexpected("cannot write a merged run or the output");
+         }
+
+         return {};
+      }
+
+   private:
+      // False if the previous block could not be written.
+      auto flush() -> bool
+      {
+         if (m_pending.valid() and not m_pending.get())
+         {
+            return false;
+         }
+
+         std::swap(m_filling, m_writing);
+         m_pending = std::async(std::launch::async,
+                                [file = m_file.get(), block = m_writing.get(), size = m_size] {
+                                   return std::fwrite(block, sizeof(i32), size, file) == size;
+                                });
+         m_size = 0;
+
+         return true;
+      }
+
+   private:
+      file_handle m_file;
+      std::size_t m_block_size;
+      block_buffer m_filling;
+      block_buffer m_writing;
+      std::size_t m_size = 0;
+      std::future<bool> m_pending;
+   };
+
+   /**
+    * Tournament over the heads of sorted streams. The root holds the stream with the smallest
+    * head and every inner node the loser of the match played there, so that replacing the head of
+    * the winner replays a single path of log2(k) matches instead of sifting a heap down and up.
+    */
+   class loser_tree
+   {
+   public:
+      // The head of a stream that ran dry, greater than any i32.
+      static constexpr i64 exhausted = std::numeric_limits<i64>::max();
+
+      explicit loser_tree(std::span<const i64> heads) :
+         m_leaf_count(std::bit_ceil(std::max<std::size_t>(heads.size(), 1))),
+         m_heads(m_leaf_count, exhausted), m_nodes(m_leaf_count, 0)
+      {
+         std::ranges::copy(heads, begin(m_heads));
+
+         // Winners of the matches bottom-up, leaves in the upper half.
+         auto winners = std::vector<std::size_t>(2 * m_leaf_count);
+         for (std::size_t leaf = 0; leaf < m_leaf_count; ++leaf)
+         {
+            winners[m_leaf_count + leaf] = leaf;
+         }
+         for (std::size_t node = m_leaf_count - 1; node > 0; --node)
+         {
+            const std::size_t left = winners[2 * node];
+            const std::size_t right = winners[2 * node + 1];
+            const bool left_wins = m_heads[left] <= m_heads[right];
+
+            winners[node] = left_wins ? left : right;
+            m_nodes[node] = left_wins ? right : left;
+         }
+         m_nodes[0] = winners[1];
+      }
+
+      [[nodiscard]] auto winner() const noexcept -> std::size_t
+      {
+         return m_nodes[0];
+      }
+      [[nodiscard]] auto winning_head() const noexcept -> i64
+      {
+         return m_heads[m_nodes[0]];
+      }
+
+      void replace_winning_head(i64 head) noexcept
+      {
+         std::size_t winner = m_nodes[0];
+         m_heads[winner] = head;
+
+         for (std::size_t node = (m_leaf_count + winner) / 2; node > 0; node /= 2)
+         {
+            if (m_heads[m_nodes[node]] < m_heads[winner])
+            {
+               std::swap(m_nodes[node], winner);
+            }
+         }
+         m_nodes[0] = winner;
+      }
+
+   private:
+      std::size_t m_leaf_count;
+      std::vector<i64> m_heads;
+      std::vector<std::size_t> m_nodes;
+   };
+
+   auto run_path(const std::filesystem::path& directory, u32 pass, std::size_t index)
+      -> std::filesystem::path
+   {
+      return directory /
+         ("run-" + std::to_string(pass) + "-" + std::to_string(index) + ".bin");
+   }
+
+   // Sorts the input chunk by chunk into runs, returns their paths.
+   auto form_runs(const external_sort_options& opts, work_stealing_pool& pool,
+                  external_sort_report& report)
+      -> std::expected<std::vector<std::filesystem::path>, std::string>
+   {
+      auto input = open_file(opts.input, "rb");
+      if (not input)
+      {
+         return std::unexpected(input.error());
+      }
+
+      // A short read only returns whole elements, trailing bytes would be dropped silently.
+      std::error_code error;
+      const std::uintmax_t file_size = std::filesystem::file_size(opts.input, error);
+      if (error)
+      {
+         return std::unexpected("cannot read the size of " + opts.input.string() + ": " +
+                                error.message());
+      }
+      if (file_size % sizeof(i32) != 0)
+      {
+         return std::unexpected(opts.input.string() + " is not a whole number of 32-bit keys");
+      }
+
+      // Two chunks are in memory at once, one sorted while the other is read.
+      const std::size_t chunk_size = std::max<std::size_t>(opts.memory_budget / (2 * sizeof(i32)),
+                                                           min_block_size);
+      auto reader = block_reader(std::move(*input), chunk_size);
+
+      std::vector<std::filesystem::path> runs;
+      while (true)
+      {
+         const auto chunk = reader.next();
+         if (not chunk)
+         {
+            return std::unexpected(chunk.error());
+         }
+         if (chunk->empty())
+         {
+            return runs;
+         }
+
+         local_sort(pool, chunk->begin(), chunk->end());
+
+         runs.push_back(run_path(opts.scratch_directory, 0, runs.size()));
+
+         auto run = open_file(runs.back(), "wb");
+         if (not run)
+         {
+            return std::unexpected(run.error());
+         }
+         if (std::fwrite(chunk->data(), sizeof(i32), chunk->size(), run->get()) != chunk->size())
+         {
+            return std::unexpected("cannot write " + runs.back().string());
+         }
+
+         report.element_count += chunk->size();
+      }
+   }
+
+   // Merges the sorted `runs` into `output`, reading and writing blocks of `block_size`.
+   auto merge_runs(std::span<const std::filesystem::path> runs,
+                   const std::filesystem::path& output, std::size_t block_size)
+      -> std::expected<void, std::string>
+   {
+      struct stream
+      {
+         std::unique_ptr<block_reader> reader;
+         std::span<i32> block = {};
+         std::size_t position = 0;
+      };
+
+      std::vector<stream> streams;
+      streams.reserve(runs.size());
+
+      std::vector<i64> heads;
+      heads.reserve(runs.size());
+
+      for (const auto& path : runs)
+      {
+         auto file = open_file(path, "rb");
+         if (not file)
+         {
+            return std::unexpected(file.error());
+         }
+
+         auto& run = streams.emplace_back(
+            stream{.reader = std::make_unique<block_reader>(std::move(*file), block_size)});
+
+         const auto block = run.reader->next();
+         if (not block)
+         {
+            return std::unexpected(block.error());
+         }
+
+         run.block = *block;
+         heads.push_back(run.block.empty() ? loser_tree::exhausted : run.block.front());
+      }
+
+      auto tree = loser_tree(heads);
+
+      auto file = open_file(output, "wb");
+      if (not file)
+      {
+         return std::unexpected(file.error());
+      }
+
+      auto writer = block_writer(std::move(*file), block_size);
+
+      while (tree.winning_head() != loser_tree::exhausted)
+      {
+         if (not writer.push(static_cast<i32>(tree.winning_head())))
+         {
+            return std::unexpected("cannot write " + output.string());
+         }
+
+         auto& run = streams[tree.winner()];
+         if (++run.position == run.block.size())
+         {
+            const auto block = run.reader->next();
+            if (not block)
+            {
+               return std::unexpected(block.error());
+            }
+
+            run.block = *block;
+            run.position = 0;
+         }
+
+         tree.replace_winning_head(run.position < run.block.size() ? run.block[run.position]
+                                                                   : loser_tree::exhausted);
+      }
+
+      return writer.finish();
+   }
+
+   // Moves the only run to the output, copying it when they are on different file systems.
+   auto move_run(const std::filesystem::path& run, const std::filesystem::path& output)
+      -> std::expected<void, std::string>
+   {
+      std::error_code error;
+      std::filesystem::rename(run, output, error);
+      if (not error)
+      {
+         return {};
+      }
+
+      std::filesystem::copy_file(run, output, std::filesystem::copy_options::overwrite_existing,
+                                 error);
+      if (error)
+      {
+         return std::unexpected("cannot write " + output.string() + ": " + error.message());
+      }
+
+      std::filesystem::remove(run, error);
+
+      return {};
+   }
+} // namespace
+
+auto external_sort(const external_sort_options& opts, work_stealing_pool& pool)
+   -> std::expected<external_sort_report, std::string>
+{
+   external_sort_report report;
+
+   std::error_code error;
+   std::filesystem::create_directories(opts.scratch_directory, error);
+   if (error)
+   {
+      return std::unexpected("cannot create " + opts.scratch_directory.string() + ": " +
+                             error.message());
+   }
+
+   const auto run_start = std::chrono::steady_clock::now();
+
+   auto runs = form_runs(opts, pool, report);
+   if (not runs)
+   {
+      return std::unexpected(runs.error());
+   }
+
+   report.run_count = runs->size();
+   report.run_seconds = seconds_since(run_start);
+
+   const auto merge_start = std::chrono::steady_clock::now();
+
+   if (runs->empty())
+   {
+      if (auto output = open_file(opts.output, "wb"); not output)
+      {
+         return std::unexpected(output.error());
+      }
+
+      return report;
+   }
+
+   // Every stream of a merge, and the output, get two blocks.
+   const u32 fan_in = std::max(opts.fan_in, 2U);
+   const std::size_t block_size = std::max<std::size_t>(
+      opts.memory_budget / (2 * sizeof(i32) * (fan_in + 1)), min_block_size);
+
+   while (runs->size() > 1)
+   {
+      ++report.merge_passes;
+
+      const bool last_pass = runs->size() <= fan_in;
+
+      std::vector<std::filesystem::path> merged;
+      for (std::size_t first = 0; first < runs->size(); first += fan_in)
+      {
+         const auto group = std::span(*runs).subspan(
+            first, std::min<std::size_t>(fan_in, runs->size() - first));
+
+         merged.push_back(last_pass
+                             ? opts.output
+                             : run_path(opts.scratch_directory, report.merge_passes,
+                                        merged.size()));
+
+         if (auto result = merge_runs(group, merged.back(), block_size); not result)
+         {
+            return std::unexpected(result.error());
+         }
+
+         for (const auto& run : group)
+         {
+            std::filesystem::remove(run, error);
+         }
+      }
+
+      *runs = std::move(merged);
+   }
+
+   if (report.merge_passes == 0)
+   {
+      if (auto result = move_run(runs->front(), opts.output); not result)
+      {
+         return std::unexpected(result.error());
+      }
+   }
+
+   report.merge_seconds = seconds_since(merge_start);
+
+   return report;
+}
@@ -0,0 +1,46 @@
+#ifndef SEQUENTIAL_QSORT_EXTERNAL_SORT_HPP_
+#define SEQUENTIAL_QSORT_EXTERNAL_SORT_HPP_
+
+#include <sequential-qsort/types.hpp>
+
+#include <libqsort/work_stealing_pool.hpp>
+
+#include <expected>
+#include <filesystem>
+#include <string>
+
+struct external_sort_options
+{
+   std::filesystem::path input;
+   std::filesystem::path output;
+   std::filesystem::path scratch_directory;
+
+   // Memory for the chunks sorted in memory, then shared by the buffers of a merge.
+   u64 memory_budget = u64{256} << 20;
+
+   // Runs merged at once, more runs take several merge passes.
+   u32 fan_in = 64;
+};
+
+struct external_sort_report
+{
+   u64 element_count = 0;
+   u64 run_count = 0;
+   u32 merge_passes = 0;
+
+   f64 run_seconds = 0.0;
+   f64 merge_seconds = 0.0;
+};
+
+/**
+ * Sorts a binary file of native i32 that need not fit in memory. The input is streamed in chunks
+ * of half the memory budget, the next one being read while the current one is sorted on `pool`
+ * and written to the scratch directory as a sorted run. The runs are then merged `fan_in` at a
+ * time, pass after pass, into the output. Every run is read and written in large blocks, each
+ * with a second block in flight on another thread, so that the merge waits on the disk rather
+ * than the disk on the merge.
+ */
+auto external_sort(const external_sort_options& opts, work_stealing_pool& pool)
+   -> std::expected<external_sort_report, std::string>;
+
+#endif // SEQUENTIAL_QSORT_EXTERNAL_SORT_HPP_
@@ -0,0 +1,148 @@
+#include <sequential-qsort/options.hpp>
+
+#include <charconv>
+#include <string_view>
+
+namespace
+{
+   template <typename T>
+   auto parse_number(std::string_view name, std::string_view text) -> std::expected<T, std::string>
+   {
+      T value{};
+      const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+      if (error != std::errc() or end != text.data() + text.size())
+      {
+         return std::unexpected("invalid value '" + std::string(text) + "' for " +
+                                std::string(name));
+      }
+
+      return value;
+   }
+
+   // Parses the value following the option at `args[i]` and moves `i` past it.
+   template <typename T>
+   auto next_number(std::span<char*> args, std::size_t& i) -> std::expected<T, std::string>
+   {
+      const std::string_view name = args[i];
+      if (i + 1 >= args.size())
+      {
+         return std::unexpected("missing value for " + std::string(name));
+      }
+
+      return parse_number<T>(name, args[++i]);
+   }
+
+   // The value following the option at `args[i]`, moving `i` past it.
+   auto next_string(std::span<char*> args, std::size_t& i)
+      -> std::expected<std::string_view, std::string>
+   {
+      const std::string_view name = args[i];
+      if (i + 1 >= args.size())
+      {
+         return std::unexpected("missing value for " + std::string(name));
+      }
+
+      return args[++i];
+   }
+} // namespace
+
+auto parse_options(std::span<char*> args) -> std::expected<options, std::string>
+{
+   options result;
+
+   for (std::size_t i = 1; i < args.size(); ++i)
+   {
+      const std::string_view arg = args[i];
+
+      if (arg == "--threads")
+      {
+         const auto thread_count = next_number<u32>(args, i);
+         if (not thread_count)
+         {
+            return std::unexpected(thread_count.error());
+         }
+
+         result.thread_count = *thread_count;
+      }
+      else if (arg == "--input")
+      {
+         const auto path = next_string(args, i);
+         if (not path)
+         {
+            return std::unexpected(path.error());
+         }
+
+         result.external_sort.input = *path;
+      }
+      else if (arg == "--output")
+      {
+         const auto path = next_string(args, i);
+         if (not path)
+         {
+            return std::unexpected(path.error());
+         }
+
+         result.external_sort.output = *path;
+      }
+      else if (arg == "--scratch-dir")
+      {
+         const auto path = next_string(args, i);
+         if (not path)
+         {
+            return std::unexpected(path.error());
+         }
+
+         result.external_sort.scratch_directory = *path;
+      }
+      else if (arg == "--memory-mb")
+      {
+         const auto megabytes = next_number<u64>(args, i);
+         if (not megabytes)
+         {
+            return std::unexpected(megabytes.error());
+         }
+         if (*megabytes == 0)
+         {
+            return std::unexpected("--memory-mb must be positive");
+         }
+
+         result.external_sort.memory_budget = *megabytes << 20;
+      }
+      else if (arg == "--fan-in")
+      {
+         const auto fan_in = next_number<u32>(args, i);
+         if (not fan_in)
+         {
+            return std::unexpected(fan_in.error());
+         }
+         if (*fan_in < 2)
+         {
+            return std::unexpected("--fan-in must be at least 2");
+         }
+
+         result.external_sort.fan_in = *fan_in;
+      }
+      else
+      {
+         return std::unexpected("unknown option " + std::string(arg));
+      }
+   }
+
+   auto& external = result.external_sort;
+   result.external = not external.input.empty();
+
+   if (result.external and external.output.empty())
+   {
+      return std::unexpected("--input needs an --output file");
+   }
+   if (not result.external and not external.output.empty())
+   {
+      return std::unexpected("--output needs an --input file");
+   }
+   if (external.scratch_directory.empty())
+   {
+      external.scratch_directory = external.output.parent_path() / "qsort-runs";
+   }
+
+   return result;
+}
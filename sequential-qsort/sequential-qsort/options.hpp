@@ -0,0 +1,23 @@
+#ifndef SEQUENTIAL_QSORT_OPTIONS_HPP_
+#define SEQUENTIAL_QSORT_OPTIONS_HPP_
+
+#include <sequential-qsort/external_sort.hpp>
+#include <sequential-qsort/types.hpp>
+
+#include <expected>
+#include <span>
+#include <string>
+
+struct options
+{
+   // Sorting threads, 0 starts one per CPU available to the process.
+   u32 thread_count = 0;
+
+   // Sorts the binary file given by --input into --output instead of a random array.
+   bool external = false;
+   external_sort_options external_sort;
+};
+
+auto parse_options(std::span<char*> args) -> std::expected<options, std::string>;
+
+#endif // SEQUENTIAL_QSORT_OPTIONS_HPP_
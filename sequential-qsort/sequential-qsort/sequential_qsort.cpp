@@ -1,40 +1,20 @@
+#include <sequential-qsort/external_sort.hpp>
+#include <sequential-qsort/options.hpp>
+#include <sequential-qsort/types.hpp>
+
+#include <libqsort/local_sort.hpp>
+
 #include <algorithm>
+#include <cstdlib>
 #include <functional>
 #include <iostream>
 #include <iterator>
 #include <random>
 #include <vector>
 
-using u16 = std::uint16_t;
-using u32 = std::uint32_t;
-using u64 = std::uint64_t;
-using i16 = std::int16_t;
-using i32 = std::int32_t;
-using i64 = std::int64_t;
-using f64 = double;
-
 static constexpr i64 random_generation_bound = 1000;
 static constexpr i64 total_elements = 10000;
 
-template <typename It>
-void qsort(It beg, It end)
-{
-   using value_type = typename std::iterator_traits<It>::value_type;
-
-   if (beg < end)
-   {
-      const auto pivot = std::prev(end);
-      const auto separator = std::partition(beg, std::prev(end), [pivot](const value_type& v) {
-         return v < *pivot;
-      });
-
-      std::iter_swap(separator, pivot);
-
-      qsort(beg, separator);
-      qsort(std::next(separator), end);
-   }
-}
-
 auto generate_random_array(i64 count) -> std::vector<i32>
 {
    std::random_device rd;
@@ -50,11 +30,40 @@ auto generate_random_array(i64 count) -> std::vector<i32>
    return data;
 }
 
-auto main() -> int
+auto main(int argc, char* argv[]) -> int
 {
+   const auto opts = parse_options({argv, static_cast<std::size_t>(argc)});
+   if (not opts)
+   {
+      std::cout << "error: " << opts.error() << '\n';
+
+      return EXIT_FAILURE;
+   }
+
+   auto pool = work_stealing_pool(opts->thread_count == 0 ? available_cpu_count()
+                                                          : opts->thread_count);
+
+   if (opts->external)
+   {
+      const auto report = external_sort(opts->external_sort, pool);
+      if (not report)
+      {
+         std::cout << "error: " << report.error() << '\n';
+
+         return EXIT_FAILURE;
+      }
+
+      std::cout << "elements: " << report->element_count << '\n';
+      std::cout << "runs: " << report->run_count << " (" << report->run_seconds << " s)\n";
+      std::cout << "merge passes: " << report->merge_passes << " (" << report->merge_seconds
+                << " s)\n";
+
+      return EXIT_SUCCESS;
+   }
+
    auto test = generate_random_array(total_elements);
 
-   qsort(test.begin(), test.end());
+   local_sort(pool, test.begin(), test.end());
 
    for (auto i : test)
    {
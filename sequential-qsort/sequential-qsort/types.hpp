@@ -0,0 +1,14 @@
+#ifndef SEQUENTIAL_QSORT_TYPES_HPP_
+#define SEQUENTIAL_QSORT_TYPES_HPP_
+
+#include <cstdint>
+
+using u16 = std::uint16_t;
+using u32 = std::uint32_t;
+using u64 = std::uint64_t;
+using i16 = std::int16_t;
+using i32 = std::int32_t;
+using i64 = std::int64_t;
+using f64 = double;
+
+#endif // SEQUENTIAL_QSORT_TYPES_HPP_